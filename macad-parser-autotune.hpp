@@ -0,0 +1,331 @@
+#ifndef MACAD_PARSER_AUTOTUNE_HPP
+#define MACAD_PARSER_AUTOTUNE_HPP
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "macad-parser-io.hpp"
+#include "macad-parser-swar.hpp"
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief バッチ処理で使うカーネルの種類
+ */
+enum class mac_kernel : std::uint8_t {
+  simd,  ///< `macad_parser::parse_mac_address` / `format_mac_address_to_buffer`（SIMDe）
+  swar,  ///< `macad_parser::swar::parse_mac_address` / `format_mac_address_to_buffer`
+};
+
+/**
+ * @brief 処理ごとに選んだカーネル
+ */
+struct mac_kernel_plan {
+  mac_kernel parse  = mac_kernel::simd;
+  mac_kernel format = mac_kernel::simd;
+
+  friend auto operator==(mac_kernel_plan const&, mac_kernel_plan const&) -> bool = default;
+};
+
+namespace detail {
+  inline constexpr auto AUTOTUNE_ITEMS        = std::size_t{256};
+  inline constexpr auto AUTOTUNE_FILE_VERSION = std::string_view{"macad-kernel-plan 1"};
+
+  [[nodiscard]]
+  constexpr auto kernel_name(mac_kernel const k) noexcept -> std::string_view {
+    return k == mac_kernel::swar ? "swar" : "simd";
+  }
+
+  [[nodiscard]]
+  constexpr auto kernel_from_name(std::string_view const name) noexcept -> std::optional<mac_kernel> {
+    if (name == "simd") {
+      return mac_kernel::simd;
+    }
+    if (name == "swar") {
+      return mac_kernel::swar;
+    }
+    return std::nullopt;
+  }
+
+  // 計測結果が変わりうる条件（CPUの型番とコンパイル時の命令セット）を1つの値にまとめる
+  [[nodiscard]]
+  inline auto host_fingerprint() -> std::uint64_t {
+    auto text = std::string{};
+#if defined(__AVX2__)
+    text += "avx2\n";
+#elif defined(__SSE4_2__)
+    text += "sse4.2\n";
+#elif defined(__ARM_NEON)
+    text += "neon\n";
+#else
+    text += "scalar\n";
+#endif
+    if (auto* const fp = std::fopen("/proc/cpuinfo", "r")) {
+      auto line = std::array<char, 512>{};
+      while (std::fgets(line.data(), static_cast<int>(line.size()), fp) != nullptr) {
+        auto const s = std::string_view{line.data()};
+        if (s.starts_with("model name") or s.starts_with("Model")) {
+          text += s;
+          break;
+        }
+      }
+      std::fclose(fp);
+    }
+    // FNV-1a
+    auto h = std::uint64_t{0xCBF29CE484222325ull};
+    for (auto const c : text) {
+      h ^= static_cast<unsigned char>(c);
+      h *= 0x100000001B3ull;
+    }
+    return h;
+  }
+
+  // 計測で呼び出し元の `Options::stats` のカウンタを増やさないよう、`stats` だけを除いたオプション
+  template <typename Options>
+  struct calibration_options {
+    static constexpr bool validate_delimiters = validate_delimiters_v<Options>;
+    static constexpr bool validate_hex        = validate_hex_v<Options>;
+    static constexpr char delimiter           = delimiter_v<Options>;
+    static constexpr bool uppercase           = uppercase_v<Options>;
+  };
+
+  // 計測に使うMACアドレスを、パースに使うのと同じ `Options` で `text` に17文字ずつ書き込む
+  template <typename Options>
+  void make_calibration_samples(std::span<std::uint64_t, AUTOTUNE_ITEMS> const values, std::span<char, AUTOTUNE_ITEMS * MAC_ADDRESS_STRING_LENGTH> const text) noexcept {
+    for (auto i = std::size_t{0}; i < values.size(); ++i) {
+      values[i] = (i * 0x9E3779B97F4A7C15ull) >> 16;
+      format_mac_address_to_buffer<Options>(values[i], text.subspan(i * MAC_ADDRESS_STRING_LENGTH).template first<MAC_ADDRESS_STRING_LENGTH>());
+    }
+  }
+
+  // 候補を交互に1回ずつ実行し、budget を使い切るまで繰り返して、1回あたりの最短時間が短い方を選ぶ
+  template <typename Simd, typename Swar>
+  auto pick_faster(std::chrono::nanoseconds const budget, Simd&& simd, Swar&& swar) -> mac_kernel {
+    using clock    = std::chrono::steady_clock;
+    auto best      = std::array{clock::duration::max(), clock::duration::max()};
+    auto sink      = std::uint64_t{0};
+    auto const end = clock::now() + budget;
+    do {
+      for (auto k = std::size_t{0}; k < best.size(); ++k) {
+        auto const t0 = clock::now();
+        sink += (k == 0) ? simd() : swar();
+        auto const elapsed = clock::now() - t0;
+        best[k]            = (elapsed < best[k]) ? elapsed : best[k];
+      }
+    } while (clock::now() < end);
+    // 計算が最適化で消えないようにする
+    auto volatile keep = sink;
+    static_cast<void>(keep);
+    return best[1] < best[0] ? mac_kernel::swar : mac_kernel::simd;
+  }
+}  // namespace detail
+
+/**
+ * @brief 各カーネルをこのマシンで実測し、処理ごとに速い方を選ぶ
+ *
+ * 17文字ちょうどの `std::string_view` を `AUTOTUNE_ITEMS` 個パース/フォーマットする処理を、
+ * 候補ごとに交互に実行して最短時間を比べます。かかる時間はおおよそ `budget` の2倍です
+ *
+ * @tparam UserOptions 実際に使うオプション（検証の有無で速い方が変わるため。`UserOptions::stats` は計測では呼ばない）
+ * @param budget 処理1つあたりの計測時間
+ */
+template <typename UserOptions = parse_mac_options>
+[[nodiscard]]
+auto calibrate_mac_kernels(std::chrono::microseconds const budget = std::chrono::milliseconds{2}) -> mac_kernel_plan {
+  using Options = detail::calibration_options<UserOptions>;
+
+  auto values = std::array<std::uint64_t, detail::AUTOTUNE_ITEMS>{};
+  auto text   = std::array<char, detail::AUTOTUNE_ITEMS * MAC_ADDRESS_STRING_LENGTH>{};
+  detail::make_calibration_samples<Options>(values, text);
+  auto const line = [&](std::size_t const i) { return std::string_view{text.data() + i * MAC_ADDRESS_STRING_LENGTH, MAC_ADDRESS_STRING_LENGTH}; };
+  auto       out  = std::array<char, MAC_ADDRESS_STRING_LENGTH>{};
+
+  auto plan  = mac_kernel_plan{};
+  plan.parse = detail::pick_faster(
+    budget,
+    [&] {
+      auto acc = std::uint64_t{0};
+      for (auto i = std::size_t{0}; i < values.size(); ++i) {
+        acc += parse_mac_address<Options>(line(i)).value_or(0);
+      }
+      return acc;
+    },
+    [&] {
+      auto acc = std::uint64_t{0};
+      for (auto i = std::size_t{0}; i < values.size(); ++i) {
+        acc += swar::parse_mac_address<Options>(line(i)).value_or(0);
+      }
+      return acc;
+    });
+  plan.format = detail::pick_faster(
+    budget,
+    [&] {
+      auto acc = std::uint64_t{0};
+      for (auto const v : values) {
+        format_mac_address_to_buffer<Options>(v, out);
+        acc += static_cast<unsigned char>(out[16]);
+      }
+      return acc;
+    },
+    [&] {
+      auto acc = std::uint64_t{0};
+      for (auto const v : values) {
+        swar::format_mac_address_to_buffer<Options>(v, out);
+        acc += static_cast<unsigned char>(out[16]);
+      }
+      return acc;
+    });
+  return plan;
+}
+
+/**
+ * @brief 保存したカーネルの選択を読み込む
+ *
+ * @return ファイルがない・形式が違う・別のマシン（CPUの型番か命令セットが違う）で保存した場合は `std::nullopt`
+ */
+[[nodiscard]]
+inline auto load_mac_kernel_plan(std::string const& path) -> std::optional<mac_kernel_plan> {
+  auto* const fp = std::fopen(path.c_str(), "r");
+  if (fp == nullptr) {
+    return std::nullopt;
+  }
+  auto lines = std::array<std::array<char, 64>, 4>{};
+  auto ok    = true;
+  for (auto& l : lines) {
+    ok = ok and std::fgets(l.data(), static_cast<int>(l.size()), fp) != nullptr;
+  }
+  std::fclose(fp);
+  if (not ok) {
+    return std::nullopt;
+  }
+
+  // 各行は "<key> <value>\n"
+  auto const field = [&](std::size_t const i, std::string_view const key) -> std::optional<std::string_view> {
+    auto s = std::string_view{lines[i].data()};
+    if (s.ends_with('\n')) {
+      s.remove_suffix(1);
+    }
+    if (not s.starts_with(key) or s.size() <= key.size() or s[key.size()] != ' ') {
+      return std::nullopt;
+    }
+    return s.substr(key.size() + 1);
+  };
+
+  auto const version = std::string_view{lines[0].data()};
+  auto const host    = field(1, "host");
+  auto const parse   = field(2, "parse");
+  auto const format  = field(3, "format");
+  if (version.substr(0, version.find('\n')) != detail::AUTOTUNE_FILE_VERSION or not host or not parse or not format) {
+    return std::nullopt;
+  }
+  auto fingerprint = std::uint64_t{};
+  if (std::from_chars(host->data(), host->data() + host->size(), fingerprint, 16).ec != std::errc{} or fingerprint != detail::host_fingerprint()) {
+    return std::nullopt;
+  }
+  auto const parse_choice  = detail::kernel_from_name(*parse);
+  auto const format_choice = detail::kernel_from_name(*format);
+  if (not parse_choice or not format_choice) {
+    return std::nullopt;
+  }
+  return mac_kernel_plan{*parse_choice, *format_choice};
+}
+
+/**
+ * @brief カーネルの選択を保存する
+ *
+ * 呼び出しごとに別の一時ファイルに書いてから置き換えるため、同時に起動した別プロセスが書きかけのファイルや
+ * 2つのプロセスの書き込みが混ざったファイルを読むことはありません
+ *
+ * @return 書き込めなかった場合は false
+ */
+inline auto save_mac_kernel_plan(std::string const& path, mac_kernel_plan const& plan) -> bool {
+  auto const parse  = detail::kernel_name(plan.parse);
+  auto const format = detail::kernel_name(plan.format);
+  return detail::replace_file(path, [&](std::FILE* const fp) {
+    return std::fprintf(fp, "%.*s\nhost %016llx\nparse %.*s\nformat %.*s\n", static_cast<int>(detail::AUTOTUNE_FILE_VERSION.size()), detail::AUTOTUNE_FILE_VERSION.data(),
+                        static_cast<unsigned long long>(detail::host_fingerprint()), static_cast<int>(parse.size()), parse.data(), static_cast<int>(format.size()), format.data()) > 0;
+  });
+}
+
+/**
+ * @brief 保存したカーネルの選択を読み込み、使えなければ実測して保存する
+ *
+ * 起動時に1回呼び、結果をバッチ処理の `plan` 引数に渡します
+ * 2回目以降の起動では実測を省略します（マシンが変わった場合は実測し直します）
+ *
+ * @tparam Options 実際に使うオプション
+ * @param path 選択を保存するファイル
+ * @param budget 処理1つあたりの計測時間
+ */
+template <typename Options = parse_mac_options>
+auto tune_mac_kernels(std::string const& path, std::chrono::microseconds const budget = std::chrono::milliseconds{2}) -> mac_kernel_plan {
+  if (auto const cached = load_mac_kernel_plan(path)) {
+    return *cached;
+  }
+  auto const plan = calibrate_mac_kernels<Options>(budget);
+  save_mac_kernel_plan(path, plan);
+  return plan;
+}
+
+/**
+ * @brief 選んだカーネルで複数のMACアドレス文字列をまとめてパースする
+ *
+ * 結果は `parse_mac_addresses(macs, out)` と同じです
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param plan 使うカーネル（`tune_mac_kernels` の結果）
+ * @param macs パース対象のMACアドレス文字列の並び
+ * @param out パース結果の書き込み先
+ * @return パースに成功した要素数
+ */
+template <typename Options = parse_mac_options>
+auto parse_mac_addresses(mac_kernel_plan const& plan, std::span<std::string_view const> const macs, std::span<std::optional<std::uint64_t>> const out) noexcept -> std::size_t {
+  if (plan.parse == mac_kernel::simd) {
+    return parse_mac_addresses<Options>(macs, out);
+  }
+  auto const n       = (macs.size() < out.size()) ? macs.size() : out.size();
+  auto       success = std::size_t{0};
+  for (auto i = std::size_t{0}; i < n; ++i) {
+    out[i] = swar::parse_mac_address<Options>(macs[i]);
+    success += out[i].has_value() ? 1 : 0;
+  }
+  return success;
+}
+
+/**
+ * @brief 選んだカーネルで複数の48bit整数をMACアドレス文字列に変換する
+ *
+ * 結果は `format_mac_addresses_to_buffer(macs, buffer)` と同じです
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param plan 使うカーネル（`tune_mac_kernels` の結果）
+ * @param macs 48bit整数値の並び
+ * @param buffer 出力先のバッファ（`macs.size() * 17` バイトが必要）
+ * @return 書き込まれた文字数
+ */
+template <typename Options = parse_mac_options>
+auto format_mac_addresses_to_buffer(mac_kernel_plan const& plan, std::span<std::uint64_t const> const macs, std::span<char> const buffer) -> std::size_t {
+  if (plan.format == mac_kernel::simd) {
+    return format_mac_addresses_to_buffer<Options>(macs, buffer);
+  }
+  auto const capacity = buffer.size() / MAC_ADDRESS_STRING_LENGTH;
+  auto const n        = (macs.size() < capacity) ? macs.size() : capacity;
+  for (auto i = std::size_t{0}; i < n; ++i) {
+    swar::format_mac_address_to_buffer<Options>(macs[i], buffer.subspan(i * MAC_ADDRESS_STRING_LENGTH).first<MAC_ADDRESS_STRING_LENGTH>());
+  }
+  return n * MAC_ADDRESS_STRING_LENGTH;
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_AUTOTUNE_HPP */
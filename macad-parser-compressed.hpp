@@ -0,0 +1,453 @@
+#ifndef MACAD_PARSER_COMPRESSED_HPP
+#define MACAD_PARSER_COMPRESSED_HPP
+
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// zlib / zstd はインクルードできる場合だけ使う（ビルド側で 0 を定義すると使わない。使う場合はリンクが必要）
+#if !defined(MACAD_PARSER_HAS_ZLIB)
+#if __has_include(<zlib.h>)
+#define MACAD_PARSER_HAS_ZLIB 1
+#else
+#define MACAD_PARSER_HAS_ZLIB 0
+#endif
+#endif
+
+#if !defined(MACAD_PARSER_HAS_ZSTD)
+#if __has_include(<zstd.h>)
+#define MACAD_PARSER_HAS_ZSTD 1
+#else
+#define MACAD_PARSER_HAS_ZSTD 0
+#endif
+#endif
+
+#if MACAD_PARSER_HAS_ZLIB
+#include <zlib.h>
+#endif
+#if MACAD_PARSER_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+#include "macad-parser-padded.hpp"
+#include "macad-parser-pipeline.hpp"
+#include "macad-parser-stream.hpp"
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief 入力の圧縮形式
+ */
+enum class compression_format {
+  none,  ///< 非圧縮
+  gzip,  ///< gzip（複数のメンバを連結したものを含む）
+  zstd,  ///< Zstandard（複数のフレームを連結したものを含む）
+};
+
+/**
+ * @brief 先頭のマジックナンバーから圧縮形式を判定する
+ *
+ * @param head 入力の先頭（4byte以上あれば判定できる）
+ */
+[[nodiscard]]
+constexpr auto detect_compression(std::span<char const> const head) noexcept -> compression_format {
+  auto const byte = [&](std::size_t const i) { return static_cast<unsigned char>(head[i]); };
+  if (head.size() >= 2 and byte(0) == 0x1F and byte(1) == 0x8B) {
+    return compression_format::gzip;
+  }
+  if (head.size() >= 4 and byte(0) == 0x28 and byte(1) == 0xB5 and byte(2) == 0x2F and byte(3) == 0xFD) {
+    return compression_format::zstd;
+  }
+  return compression_format::none;
+}
+
+/**
+ * @brief 圧縮形式をこのビルドで展開できるか
+ */
+[[nodiscard]]
+constexpr auto is_compression_supported(compression_format const format) noexcept -> bool {
+  switch (format) {
+  case compression_format::gzip:
+    return MACAD_PARSER_HAS_ZLIB != 0;
+  case compression_format::zstd:
+    return MACAD_PARSER_HAS_ZSTD != 0;
+  default:
+    return true;
+  }
+}
+
+/**
+ * @brief 展開とパースを重ねて実行した結果
+ */
+struct compressed_scan_metrics {
+  /**
+   * @brief ステージの種類
+   */
+  enum class stage { decompress, parse };
+
+  compression_format format = compression_format::none;
+  bool               ok     = true;  ///< 入力が壊れている・このビルドで展開できない形式だった場合は false（それまでに見つかった分は報告済み）
+  std::uint64_t      compressed_bytes = 0;  ///< 読み込んだ圧縮データのバイト数
+  std::uint64_t      macs             = 0;  ///< 見つかったMACアドレスの数
+  stage_metrics      decompress;            ///< 展開ステージ（圧縮データの読み込みを含む。bytes は展開後のバイト数）
+  stage_metrics      parse;                 ///< パースステージ
+
+  /**
+   * @brief ボトルネックになっているステージ（稼働率が高い方）
+   */
+  [[nodiscard]]
+  auto bottleneck() const noexcept -> stage {
+    return decompress.utilization() >= parse.utilization() ? stage::decompress : stage::parse;
+  }
+};
+
+/**
+ * @brief 展開とパースを重ねて実行する設定
+ */
+struct compressed_scan_config {
+  std::size_t buffer_size = std::size_t{1} << 20;  ///< 展開先のバッファ1つの大きさ
+  std::size_t buffers     = 4;                     ///< 展開先のバッファの数（展開ステージが先行できる量）
+  std::size_t input_size  = std::size_t{1} << 18;  ///< 圧縮データを1回に読み込むバイト数
+};
+
+namespace detail {
+  // 展開済みのデータを入れたバッファ
+  struct decompressed_block {
+    padded_string buffer;
+    std::size_t   size = 0;
+  };
+
+  // 圧縮データの入力（先頭の判定に使った分も含めて順に渡す）
+  template <typename Read>
+  class compressed_input {
+  public:
+    compressed_input(Read& read, std::size_t const size) : read_{read}, buffer_(size < 4 ? 4 : size) {}
+
+    // 空になっていれば読み込む（終端なら false）
+    auto fill() -> bool {
+      if (pos_ < size_) {
+        return true;
+      }
+      pos_  = 0;
+      size_ = read_(std::span<char>{buffer_});
+      total_ += size_;
+      return size_ > 0;
+    }
+
+    // 判定に必要な4byteをそろえる（終端に達した場合はそろわない）
+    void peek_magic() {
+      size_ = 0;
+      while (size_ < 4) {
+        auto const n = read_(std::span<char>{buffer_}.subspan(size_));
+        if (n == 0) {
+          break;
+        }
+        size_ += n;
+      }
+      total_ += size_;
+    }
+
+    [[nodiscard]]
+    auto available() const noexcept -> std::span<char const> {
+      return std::span<char const>{buffer_}.subspan(pos_, size_ - pos_);
+    }
+    void consume(std::size_t const n) noexcept {
+      pos_ += n;
+    }
+    [[nodiscard]]
+    auto total() const noexcept -> std::uint64_t {
+      return total_;
+    }
+
+  private:
+    Read&             read_;
+    std::vector<char> buffer_;
+    std::size_t       pos_   = 0;
+    std::size_t       size_  = 0;
+    std::uint64_t     total_ = 0;
+  };
+
+  // 展開器は `out` を埋められるだけ埋め、書き込んだバイト数を返す（0で終端、nullopt で入力の破損）
+
+  template <typename Read>
+  class copy_decoder {
+  public:
+    explicit copy_decoder(compressed_input<Read>& in) noexcept : in_{in} {}
+
+    auto decode(std::span<char> const out) -> std::optional<std::size_t> {
+      auto filled = std::size_t{0};
+      while (filled < out.size() and in_.fill()) {
+        auto const src = in_.available();
+        auto const n   = (src.size() < out.size() - filled) ? src.size() : out.size() - filled;
+        std::memcpy(out.data() + filled, src.data(), n);
+        in_.consume(n);
+        filled += n;
+      }
+      return filled;
+    }
+
+  private:
+    compressed_input<Read>& in_;
+  };
+
+#if MACAD_PARSER_HAS_ZLIB
+  template <typename Read>
+  class gzip_decoder {
+  public:
+    explicit gzip_decoder(compressed_input<Read>& in) noexcept : in_{in} {
+      // 15 + 32: 最大のウィンドウでgzip/zlibのヘッダを自動判定する
+      ok_ = inflateInit2(&stream_, 15 + 32) == Z_OK;
+    }
+    gzip_decoder(gzip_decoder const&)                    = delete;
+    auto operator=(gzip_decoder const&) -> gzip_decoder& = delete;
+    ~gzip_decoder() {
+      if (ok_) {
+        inflateEnd(&stream_);
+      }
+    }
+
+    auto decode(std::span<char> const out) -> std::optional<std::size_t> {
+      if (not ok_) {
+        return std::nullopt;
+      }
+      auto filled = std::size_t{0};
+      while (filled < out.size()) {
+        // 入力を読み終えていても、メンバの途中なら zlib 内に残った出力を取り出す
+        auto const has_input = in_.fill();
+        if (not has_input and not in_member_) {
+          break;
+        }
+        auto const src    = in_.available();
+        stream_.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(src.data()));
+        stream_.avail_in  = static_cast<uInt>(src.size());
+        stream_.next_out  = reinterpret_cast<Bytef*>(out.data() + filled);
+        stream_.avail_out = static_cast<uInt>(out.size() - filled);
+        auto const ret    = inflate(&stream_, Z_NO_FLUSH);
+        in_.consume(src.size() - stream_.avail_in);
+        filled = out.size() - stream_.avail_out;
+        if (ret == Z_STREAM_END) {
+          // 連結された次のメンバに備える
+          in_member_ = false;
+          inflateReset(&stream_);
+        } else if (ret == Z_OK or (ret == Z_BUF_ERROR and has_input)) {
+          in_member_ = true;
+        } else {
+          // メンバの途中で入力が終わった場合も破損として扱う
+          return std::nullopt;
+        }
+      }
+      return filled;
+    }
+
+  private:
+    compressed_input<Read>& in_;
+    z_stream                stream_{};
+    bool                    ok_        = false;
+    bool                    in_member_ = false;
+  };
+#endif
+
+#if MACAD_PARSER_HAS_ZSTD
+  template <typename Read>
+  class zstd_decoder {
+  public:
+    explicit zstd_decoder(compressed_input<Read>& in) noexcept : in_{in}, context_{ZSTD_createDCtx()} {}
+    zstd_decoder(zstd_decoder const&)                    = delete;
+    auto operator=(zstd_decoder const&) -> zstd_decoder& = delete;
+    ~zstd_decoder() {
+      ZSTD_freeDCtx(context_);
+    }
+
+    auto decode(std::span<char> const out) -> std::optional<std::size_t> {
+      if (context_ == nullptr) {
+        return std::nullopt;
+      }
+      auto output = ZSTD_outBuffer{out.data(), out.size(), 0};
+      while (output.pos < output.size) {
+        // 入力を読み終えていても、フレームの途中なら libzstd 内に残った出力を取り出す
+        auto const has_input = in_.fill();
+        if (not has_input and not in_frame_) {
+          break;
+        }
+        auto const src    = in_.available();
+        auto       input  = ZSTD_inBuffer{src.data(), src.size(), 0};
+        auto const before = output.pos;
+        auto const ret    = ZSTD_decompressStream(context_, &output, &input);
+        in_.consume(input.pos);
+        if (ZSTD_isError(ret)) {
+          return std::nullopt;
+        }
+        // 0 はフレームの終わり（入力のない呼び出しで最後の出力を取り出した場合も含む。連結された次のフレームはそのまま続けて展開できる）
+        if (ret == 0) {
+          in_frame_ = false;
+          continue;
+        }
+        if (not has_input and output.pos == before) {
+          // フレームの途中で入力が終わった場合も破損として扱う
+          return std::nullopt;
+        }
+        in_frame_ = true;
+      }
+      return output.pos;
+    }
+
+  private:
+    compressed_input<Read>& in_;
+    ZSTD_DCtx*              context_;
+    bool                    in_frame_ = false;
+  };
+#endif
+
+  // 空きバッファを待つ（停止が要求されたら nullopt）
+  inline auto pop_until_stopped(spsc_ring<decompressed_block>& ring, std::stop_token const& stop, std::chrono::nanoseconds& waited) -> std::optional<decompressed_block> {
+    auto const start = std::chrono::steady_clock::now();
+    while (not stop.stop_requested()) {
+      if (auto block = ring.try_pop()) {
+        waited += std::chrono::steady_clock::now() - start;
+        return block;
+      }
+      std::this_thread::yield();
+    }
+    return std::nullopt;
+  }
+
+  // 展開済みのバッファを渡す（停止が要求されたら false）
+  inline auto push_until_stopped(spsc_ring<decompressed_block>& ring, decompressed_block& block, std::stop_token const& stop, std::chrono::nanoseconds& waited) -> bool {
+    auto const start = std::chrono::steady_clock::now();
+    while (not ring.try_push(block)) {
+      if (stop.stop_requested()) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    waited += std::chrono::steady_clock::now() - start;
+    return true;
+  }
+}  // namespace detail
+
+/**
+ * @brief 圧縮されたバイト列のソースを展開しながら、MACアドレスを取り出す
+ *
+ * 展開は別スレッドで行い、展開済みのバッファ（`padded_string`）を `spsc_ring` で呼び出し元のスレッドに渡します
+ * 呼び出し元のスレッドは受け取ったバッファを `mac_stream_scanner` で走査し、使い終わったバッファを展開スレッドに返します
+ * そのため展開とSIMDによるパースは重なって進み、一時ファイルは作りません
+ * 圧縮形式は先頭のマジックナンバーで判定します（gzipはzlib、zstdはlibzstdがビルド時に使える場合だけ展開できる。それ以外はそのまま走査する）
+ * どちらのステージが律速しているかは、返り値の `bottleneck()` とステージごとの稼働率で確認できます
+ *
+ * @tparam Options デリミタを指定するオプション（`scan_mac_addresses` に渡す）
+ * @param read `read(std::span<char> buffer) -> std::size_t` の形で展開スレッドから呼ばれ、読み込んだバイト数を返す（0で終端）
+ * @param on_match 見つかるたびに呼び出し元のスレッドで `on_match(std::size_t offset, std::uint64_t value)` の形で呼ばれる（offset は展開後の位置）
+ * @param config 展開先のバッファの設定
+ * @return 各ステージの計測結果
+ */
+template <typename Options = parse_mac_options, typename Read, typename F>
+  requires std::invocable<Read&, std::span<char>>
+auto scan_compressed_mac_addresses(Read read, F&& on_match, compressed_scan_config const& config = {}) -> compressed_scan_metrics {
+  using clock = std::chrono::steady_clock;
+
+  auto const buffers = (config.buffers < 2) ? std::size_t{2} : config.buffers;
+  auto       ready   = spsc_ring<detail::decompressed_block>{buffers};
+  auto       free    = spsc_ring<detail::decompressed_block>{buffers};
+  for (auto i = std::size_t{0}; i < buffers; ++i) {
+    auto block = detail::decompressed_block{padded_string{config.buffer_size}, 0};
+    free.try_push(block);
+  }
+
+  auto metrics = compressed_scan_metrics{};
+  auto failure = std::exception_ptr{};
+
+  auto run_decoder = [&](std::stop_token const& stop, auto& decoder) {
+    while (auto block = detail::pop_until_stopped(free, stop, metrics.decompress.wait)) {
+      auto const start = clock::now();
+      auto const n     = decoder.decode(std::span<char>{block->buffer.data(), block->buffer.size()});
+      metrics.decompress.busy += clock::now() - start;
+      if (not n) {
+        metrics.ok = false;
+        return;
+      }
+      if (*n == 0) {
+        return;
+      }
+      block->size = *n;
+      metrics.decompress.bytes += *n;
+      ++metrics.decompress.items;
+      if (not detail::push_until_stopped(ready, *block, stop, metrics.decompress.wait)) {
+        return;
+      }
+    }
+  };
+
+  {
+    auto decompressor = std::jthread{[&](std::stop_token const stop) {
+      try {
+        auto in = detail::compressed_input<Read>{read, config.input_size};
+        in.peek_magic();
+        metrics.format = detect_compression(in.available());
+        if (metrics.format == compression_format::none) {
+          auto decoder = detail::copy_decoder<Read>{in};
+          run_decoder(stop, decoder);
+        }
+#if MACAD_PARSER_HAS_ZLIB
+        if (metrics.format == compression_format::gzip) {
+          auto decoder = detail::gzip_decoder<Read>{in};
+          run_decoder(stop, decoder);
+        }
+#endif
+#if MACAD_PARSER_HAS_ZSTD
+        if (metrics.format == compression_format::zstd) {
+          auto decoder = detail::zstd_decoder<Read>{in};
+          run_decoder(stop, decoder);
+        }
+#endif
+        metrics.ok = metrics.ok and is_compression_supported(metrics.format);
+        metrics.compressed_bytes = in.total();
+      } catch (...) {
+        failure = std::current_exception();
+      }
+      ready.close();
+    }};
+
+    // 呼び出し元のスレッドでパースする（on_match が例外を投げた場合は jthread のデストラクタが展開スレッドを止める）
+    auto scanner = mac_stream_scanner<Options>{};
+    while (auto block = detail::pop_blocking(ready, metrics.parse.wait)) {
+      auto const start = clock::now();
+      metrics.macs += scanner.feed(std::span<char const>{block->buffer.data(), block->size}, on_match);
+      metrics.parse.bytes += block->size;
+      ++metrics.parse.items;
+      metrics.parse.busy += clock::now() - start;
+      free.try_push(*block);
+    }
+  }
+
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+  return metrics;
+}
+
+/**
+ * @brief 圧縮された（または非圧縮の）ファイルを展開しながら、MACアドレスを取り出す
+ *
+ * @param fp 入力ファイル
+ * @param on_match 見つかるたびに `on_match(std::size_t offset, std::uint64_t value)` の形で呼ばれる
+ * @param config 展開先のバッファの設定
+ */
+template <typename Options = parse_mac_options, typename F>
+auto scan_compressed_mac_addresses(std::FILE* const fp, F&& on_match, compressed_scan_config const& config = {}) -> compressed_scan_metrics {
+  return scan_compressed_mac_addresses<Options>([fp](std::span<char> const buffer) { return std::fread(buffer.data(), 1, buffer.size(), fp); }, std::forward<F>(on_match), config);
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_COMPRESSED_HPP */
@@ -0,0 +1,421 @@
+#ifndef MACAD_PARSER_INDEX_HPP
+#define MACAD_PARSER_INDEX_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MACAD_PARSER_INDEX_HAS_MMAP 1
+#endif
+
+#include "macad-parser-io.hpp"
+#include "macad-parser.hpp"
+
+/**
+ * @brief 整列済みのMACアドレスの集合を保存し、起動時にメモリマップして使うインデックスファイル
+ *
+ * ファイルは次の順に並びます（各領域は64byte境界から始まる。ヘッダ・基数表・フェンスはこのマシンのバイト順）
+ * - ヘッダ: 件数・各領域の位置・チェックサム
+ * - 基数表: 上位 `radix_bits` bitごとに、その値以上で始まる最初のブロックの番号（`2^radix_bits + 1` 個の uint32）
+ * - フェンス: 各ブロック（`MAC_INDEX_BLOCK_KEYS` 件）の最初の値（uint64）
+ * - 値: 昇順に並べた48bitの値を6byteずつ（リトルエンディアン）詰めたもの
+ *
+ * 基数表は値の分布（累積分布）を区分的に近似した表で、検索はこれで絞ったフェンスの範囲と1ブロックの中だけを二分探索します
+ */
+namespace macad_parser {
+
+/**
+ * @brief インデックスファイルでフェンス1つがまとめる値の数
+ */
+inline constexpr std::size_t MAC_INDEX_BLOCK_KEYS = 256;
+
+namespace detail {
+  inline constexpr std::array<char, 8> MAC_INDEX_MAGIC          = {'M', 'A', 'C', 'A', 'D', 'S', 'X', '1'};
+  inline constexpr std::uint32_t       MAC_INDEX_VERSION        = 1;
+  inline constexpr std::size_t         MAC_INDEX_KEY_BYTES      = 6;
+  inline constexpr std::size_t         MAC_INDEX_ALIGNMENT      = 64;
+  inline constexpr std::uint32_t       MAC_INDEX_MAX_RADIX_BITS = 24;
+  // 最後の値も8byteでロードできるように、値の後ろに置く余白
+  inline constexpr std::size_t MAC_INDEX_KEY_TAIL = 8 - MAC_INDEX_KEY_BYTES;
+
+  struct mac_index_header {
+    std::array<char, 8> magic;
+    std::uint32_t       version;
+    std::uint32_t       block_keys;
+    std::uint64_t       count;
+    std::uint64_t       fences;
+    std::uint32_t       radix_bits;
+    std::uint32_t       reserved;
+    std::uint64_t       radix_offset;
+    std::uint64_t       fence_offset;
+    std::uint64_t       key_offset;
+    std::uint64_t       file_size;
+    std::uint64_t       directory_checksum;
+    std::uint64_t       key_checksum;
+    std::uint64_t       header_checksum;
+  };
+
+  // ヘッダ自身のチェックサム（`header_checksum` 以外の部分から計算する）
+  inline auto header_checksum(mac_index_header const& header) noexcept -> std::uint64_t {
+    return checksum(&header, offsetof(mac_index_header, header_checksum));
+  }
+
+  constexpr auto align_index_offset(std::uint64_t const offset) noexcept -> std::uint64_t {
+    return (offset + MAC_INDEX_ALIGNMENT - 1) / MAC_INDEX_ALIGNMENT * MAC_INDEX_ALIGNMENT;
+  }
+
+  // フェンス数に合わせて、基数表の1項目あたりのフェンスが平均1個程度になる桁数を選ぶ
+  constexpr auto radix_bits_for(std::uint64_t const fences) noexcept -> std::uint32_t {
+    return std::clamp<std::uint32_t>(static_cast<std::uint32_t>(std::bit_width(fences)), 1, MAC_INDEX_MAX_RADIX_BITS);
+  }
+
+  inline auto load_index_key(unsigned char const* const p) noexcept -> std::uint64_t {
+    auto word = std::uint64_t{};
+    std::memcpy(&word, p, 8);
+    if constexpr (std::endian::native == std::endian::big) {
+      word = std::byteswap(word);
+    }
+    return word & 0xFFFFFFFFFFFFull;
+  }
+
+  inline void store_index_key(unsigned char* const p, std::uint64_t mac) noexcept {
+    for (auto i = std::size_t{0}; i < MAC_INDEX_KEY_BYTES; ++i, mac >>= 8) {
+      p[i] = static_cast<unsigned char>(mac);
+    }
+  }
+}  // namespace detail
+
+/**
+ * @brief MACアドレスの集合をインデックスファイルに書き出す（受け取った配列をそのまま整列に使う）
+ *
+ * 値は上位16bitを捨ててから昇順に並べ、重複を除きます（入力は整列していなくてよい）
+ * 一時ファイルに書いてから置き換えるため、途中で失敗しても既存のファイルは壊れません
+ * テキストのパースや整列はここで一度だけ行い、サービスの起動時には `mapped_mac_index::open` で開くだけにします
+ * `macs` をその場で整列するため、入力のコピーは作りません（件数が多い場合はこちらを使う）
+ *
+ * @param path 保存先
+ * @param macs 48bitのMACアドレスの並び（ムーブして渡す）
+ * @return 保存できたかどうか
+ */
+inline auto write_mac_index(std::string const& path, std::vector<std::uint64_t>&& macs) -> bool {
+  auto keys = std::move(macs);
+  for (auto& key : keys) {
+    key &= 0xFFFFFFFFFFFFull;
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  auto header       = detail::mac_index_header{};
+  header.magic      = detail::MAC_INDEX_MAGIC;
+  header.version    = detail::MAC_INDEX_VERSION;
+  header.block_keys = MAC_INDEX_BLOCK_KEYS;
+  header.count      = keys.size();
+  header.fences     = (keys.size() + MAC_INDEX_BLOCK_KEYS - 1) / MAC_INDEX_BLOCK_KEYS;
+  header.radix_bits = detail::radix_bits_for(header.fences);
+
+  auto fences = std::vector<std::uint64_t>(header.fences);
+  for (auto f = std::size_t{0}; f < fences.size(); ++f) {
+    fences[f] = keys[f * MAC_INDEX_BLOCK_KEYS];
+  }
+  auto radix = std::vector<std::uint32_t>((std::size_t{1} << header.radix_bits) + 1);
+  for (auto p = std::size_t{0}, f = std::size_t{0}; p < radix.size(); ++p) {
+    while (f < fences.size() and (fences[f] >> (48 - header.radix_bits)) < p) {
+      ++f;
+    }
+    radix[p] = static_cast<std::uint32_t>(f);
+  }
+  auto packed = std::vector<unsigned char>(keys.size() * detail::MAC_INDEX_KEY_BYTES + detail::MAC_INDEX_KEY_TAIL);
+  for (auto i = std::size_t{0}; i < keys.size(); ++i) {
+    detail::store_index_key(packed.data() + i * detail::MAC_INDEX_KEY_BYTES, keys[i]);
+  }
+  // 詰めた後は不要なので、書き出す前に解放して使用メモリの最大値を抑える
+  keys = std::vector<std::uint64_t>{};
+
+  header.radix_offset       = detail::align_index_offset(sizeof(header));
+  header.fence_offset       = detail::align_index_offset(header.radix_offset + radix.size() * sizeof(std::uint32_t));
+  header.key_offset         = detail::align_index_offset(header.fence_offset + fences.size() * sizeof(std::uint64_t));
+  header.file_size          = header.key_offset + packed.size();
+  header.directory_checksum = detail::checksum(fences.data(), fences.size() * sizeof(std::uint64_t), detail::checksum(radix.data(), radix.size() * sizeof(std::uint32_t)));
+  header.key_checksum       = detail::checksum(packed.data(), packed.size());
+  header.header_checksum    = detail::header_checksum(header);
+
+  return detail::replace_file(path, [&](std::FILE* const fp) {
+    auto       written  = std::uint64_t{0};
+    auto       wrote    = true;
+    auto const write_at = [&](std::uint64_t const offset, void const* const data, std::size_t const size) {
+      static constexpr auto zeros = std::array<char, detail::MAC_INDEX_ALIGNMENT>{};
+      wrote   = wrote and std::fwrite(zeros.data(), 1, offset - written, fp) == offset - written and (size == 0 or std::fwrite(data, 1, size, fp) == size);
+      written = offset + size;
+    };
+    write_at(0, &header, sizeof(header));
+    write_at(header.radix_offset, radix.data(), radix.size() * sizeof(std::uint32_t));
+    write_at(header.fence_offset, fences.data(), fences.size() * sizeof(std::uint64_t));
+    write_at(header.key_offset, packed.data(), packed.size());
+    return wrote;
+  });
+}
+
+/**
+ * @brief MACアドレスの集合をインデックスファイルに書き出す
+ *
+ * 入力をコピーしてから整列します。呼び出し側で配列が不要になる場合は、ムーブして渡す方を使うとコピーを避けられます
+ *
+ * @param path 保存先
+ * @param macs 48bitのMACアドレスの並び
+ * @return 保存できたかどうか
+ */
+inline auto write_mac_index(std::string const& path, std::span<std::uint64_t const> const macs) -> bool {
+  return write_mac_index(path, std::vector<std::uint64_t>(macs.begin(), macs.end()));
+}
+
+/**
+ * @brief `write_mac_index(path, {a, b, ...})` や `write_mac_index(path, {})` の形で呼べるようにする
+ */
+inline auto write_mac_index(std::string const& path, std::initializer_list<std::uint64_t> const macs) -> bool {
+  return write_mac_index(path, std::span<std::uint64_t const>{macs.begin(), macs.size()});
+}
+
+/**
+ * @brief `write_mac_index` で書き出したインデックスファイルを開いて検索する
+ *
+ * ファイルはメモリマップする（使えない環境では読み込む）だけで、パースや整列はしません
+ * 開くときに検査するのはヘッダと基数表・フェンスのチェックサムだけで、値の領域全体のチェックサムは `verify` で確かめます
+ * 値の領域は検索で触れたページだけが読み込まれます
+ * 構築後は変更できず、複数スレッドから同時に検索できます
+ */
+class mapped_mac_index {
+public:
+  mapped_mac_index() noexcept = default;
+
+  mapped_mac_index(mapped_mac_index const&)                    = delete;
+  auto operator=(mapped_mac_index const&) -> mapped_mac_index& = delete;
+
+  mapped_mac_index(mapped_mac_index&& other) noexcept { swap(other); }
+
+  auto operator=(mapped_mac_index&& other) noexcept -> mapped_mac_index& {
+    if (this != &other) {
+      mapped_mac_index{std::move(other)}.swap(*this);
+    }
+    return *this;
+  }
+
+  ~mapped_mac_index() {
+#ifdef MACAD_PARSER_INDEX_HAS_MMAP
+    if (mapping_ != nullptr) {
+      ::munmap(mapping_, mapping_size_);
+    }
+#endif
+  }
+
+  /**
+   * @brief インデックスファイルを開く
+   *
+   * @param path `write_mac_index` で書き出したファイル
+   * @return 開けない・形式が違う・ヘッダや基数表・フェンスが壊れている場合は std::nullopt
+   */
+  [[nodiscard]]
+  static auto open(std::string const& path) -> std::optional<mapped_mac_index> {
+    auto index = mapped_mac_index{};
+#ifdef MACAD_PARSER_INDEX_HAS_MMAP
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return std::nullopt;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and static_cast<std::size_t>(st.st_size) >= sizeof(detail::mac_index_header)) {
+      auto const  size = static_cast<std::size_t>(st.st_size);
+      auto* const data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED) {
+        // 検索は1ブロックずつ飛び飛びに触れるため、先読みはしない
+        ::madvise(data, size, MADV_RANDOM);
+        index.mapping_      = data;
+        index.mapping_size_ = size;
+        index.data_         = static_cast<unsigned char const*>(data);
+        index.size_         = size;
+      }
+    }
+    ::close(fd);
+#endif
+    if (index.data_ == nullptr and not index.read_file(path)) {
+      return std::nullopt;
+    }
+    if (not index.attach()) {
+      return std::nullopt;
+    }
+    return index;
+  }
+
+  /**
+   * @brief 値の数
+   */
+  [[nodiscard]]
+  auto size() const noexcept -> std::size_t {
+    return count_;
+  }
+
+  [[nodiscard]]
+  auto empty() const noexcept -> bool {
+    return count_ == 0;
+  }
+
+  /**
+   * @brief `i` 番目に小さい値
+   */
+  [[nodiscard]]
+  auto operator[](std::size_t const i) const noexcept -> std::uint64_t {
+    return detail::load_index_key(keys_ + i * detail::MAC_INDEX_KEY_BYTES);
+  }
+
+  /**
+   * @brief `mac` 以上の最初の値の位置（すべて `mac` より小さい場合は `size()`）
+   *
+   * @param mac 48bitのMACアドレス（上位16bitは無視される）
+   */
+  [[nodiscard]]
+  auto lower_bound(std::uint64_t mac) const noexcept -> std::size_t {
+    mac &= 0xFFFFFFFFFFFFull;
+    if (count_ == 0) {
+      return 0;
+    }
+    // 基数表で、`mac` を含みうるブロックの最初のフェンスの範囲に絞る
+    auto const prefix = static_cast<std::size_t>(mac >> (48 - radix_bits_));
+    auto const first  = std::max<std::uint32_t>(radix_[prefix], 1) - 1;
+    auto const last   = radix_[prefix + 1];
+    auto const fence  = static_cast<std::size_t>(std::upper_bound(fences_ + first, fences_ + last, mac) - fences_);
+    if (fence == 0) {
+      return 0;
+    }
+    // `mac` 以上の値は、ブロック `fence - 1` の中か、次のブロックの先頭にある
+    auto lo = (fence - 1) * MAC_INDEX_BLOCK_KEYS;
+    auto hi = std::min(lo + MAC_INDEX_BLOCK_KEYS, count_);
+    while (lo < hi) {
+      auto const mid = lo + (hi - lo) / 2;
+      if ((*this)[mid] < mac) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /**
+   * @brief 値を含むかどうか
+   *
+   * @param mac 48bitのMACアドレス（上位16bitは無視される）
+   */
+  [[nodiscard]]
+  auto contains(std::uint64_t const mac) const noexcept -> bool {
+    auto const i = lower_bound(mac);
+    return i < count_ and (*this)[i] == (mac & 0xFFFFFFFFFFFFull);
+  }
+
+  /**
+   * @brief 値の領域全体のチェックサムを確かめる
+   *
+   * ファイル全体を読むため、起動直後ではなくバックグラウンドや定期的な検査で呼びます
+   */
+  [[nodiscard]]
+  auto verify() const noexcept -> bool {
+    return header_ != nullptr and detail::checksum(keys_, count_ * detail::MAC_INDEX_KEY_BYTES + detail::MAC_INDEX_KEY_TAIL) == header_->key_checksum;
+  }
+
+private:
+  // メモリマップを使えない場合は、ファイル全体を8byte境界に揃えたバッファに読み込む
+  auto read_file(std::string const& path) -> bool {
+    auto* const fp = std::fopen(path.c_str(), "rb");
+    if (fp == nullptr) {
+      return false;
+    }
+    auto bytes = std::vector<unsigned char>{};
+    auto chunk = std::array<unsigned char, 1 << 16>{};
+    while (auto const n = std::fread(chunk.data(), 1, chunk.size(), fp)) {
+      bytes.insert(bytes.end(), chunk.data(), chunk.data() + n);
+    }
+    auto const ok = std::ferror(fp) == 0;
+    std::fclose(fp);
+    buffer_.resize((bytes.size() + 7) / 8);
+    std::memcpy(buffer_.data(), bytes.data(), bytes.size());
+    data_ = reinterpret_cast<unsigned char const*>(buffer_.data());
+    size_ = bytes.size();
+    return ok;
+  }
+
+  // ヘッダを検査して各領域を指す
+  auto attach() noexcept -> bool {
+    if (size_ < sizeof(detail::mac_index_header)) {
+      return false;
+    }
+    auto const* const header = reinterpret_cast<detail::mac_index_header const*>(data_);
+    auto const        keys   = header->count * detail::MAC_INDEX_KEY_BYTES + detail::MAC_INDEX_KEY_TAIL;
+    auto const        radix  = ((std::uint64_t{1} << std::min(header->radix_bits, detail::MAC_INDEX_MAX_RADIX_BITS)) + 1) * sizeof(std::uint32_t);
+    auto const        ok     = header->magic == detail::MAC_INDEX_MAGIC and header->version == detail::MAC_INDEX_VERSION and header->header_checksum == detail::header_checksum(*header) and
+                    header->block_keys == MAC_INDEX_BLOCK_KEYS and header->file_size == size_ and header->count <= (std::uint64_t{1} << 48) and
+                    header->fences == (header->count + MAC_INDEX_BLOCK_KEYS - 1) / MAC_INDEX_BLOCK_KEYS and header->radix_bits == detail::radix_bits_for(header->fences) and
+                    header->radix_offset <= size_ and header->fence_offset <= size_ and header->key_offset <= size_ and header->radix_offset % 8 == 0 and
+                    header->fence_offset % 8 == 0 and header->radix_offset >= sizeof(detail::mac_index_header) and
+                    header->fence_offset >= header->radix_offset + radix and header->key_offset >= header->fence_offset + header->fences * sizeof(std::uint64_t) and
+                    header->key_offset + keys == size_;
+    if (not ok) {
+      return false;
+    }
+    auto const* const radix_table = reinterpret_cast<std::uint32_t const*>(data_ + header->radix_offset);
+    auto const* const fences      = reinterpret_cast<std::uint64_t const*>(data_ + header->fence_offset);
+    auto const        checksum    = detail::checksum(fences, header->fences * sizeof(std::uint64_t), detail::checksum(radix_table, radix));
+    if (checksum != header->directory_checksum or radix_table[radix / sizeof(std::uint32_t) - 1] != header->fences) {
+      return false;
+    }
+    header_     = header;
+    radix_      = radix_table;
+    fences_     = fences;
+    keys_       = data_ + header->key_offset;
+    count_      = static_cast<std::size_t>(header->count);
+    radix_bits_ = header->radix_bits;
+    return true;
+  }
+
+  void swap(mapped_mac_index& other) noexcept {
+    std::swap(mapping_, other.mapping_);
+    std::swap(mapping_size_, other.mapping_size_);
+    std::swap(buffer_, other.buffer_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(header_, other.header_);
+    std::swap(radix_, other.radix_);
+    std::swap(fences_, other.fences_);
+    std::swap(keys_, other.keys_);
+    std::swap(count_, other.count_);
+    std::swap(radix_bits_, other.radix_bits_);
+  }
+
+  void*                           mapping_      = nullptr;
+  std::size_t                     mapping_size_ = 0;
+  std::vector<std::uint64_t>      buffer_;
+  unsigned char const*            data_       = nullptr;
+  std::size_t                     size_       = 0;
+  detail::mac_index_header const* header_     = nullptr;
+  std::uint32_t const*            radix_      = nullptr;
+  std::uint64_t const*            fences_     = nullptr;
+  unsigned char const*            keys_       = nullptr;
+  std::size_t                     count_      = 0;
+  std::uint32_t                   radix_bits_ = 1;
+};
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_INDEX_HPP */
@@ -0,0 +1,126 @@
+#ifndef MACAD_PARSER_INTERN_HPP
+#define MACAD_PARSER_INTERN_HPP
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief 頻出するMACアドレスの文字列表現を保持する固定サイズのキャッシュ
+ *
+ * ダイレクトマップ方式で、MACアドレスの値から1つのスロットを決め、そのスロットに整形済みの文字列を持ちます
+ * ヒット時は乗算1回とスロットの読み込み・比較だけで済み、SIMDでの整形より速く文字列が得られます
+ * ミス時は `format_mac_address_to_buffer` で整形してスロットを置き換えます
+ *
+ * - 各スロットは32byteで、キャッシュラインをまたがない（1回の参照で触るキャッシュラインは1本）
+ * - メモリ使用量は `Slots * 32` バイトで一定です（`memory_footprint`）
+ * - 返す `std::string_view` は、同じスロットが別のMACアドレスで置き換えられるか `clear()` されるまで有効です
+ * - スレッドセーフではありません（スレッドごとに1つ持つことを想定）
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @tparam Slots スロット数（2のべき乗）
+ */
+template <typename Options = parse_mac_options, std::size_t Slots = 4096>
+  requires(std::has_single_bit(Slots) and Slots >= 2)
+class mac_string_intern {
+  // 48bitのMACアドレスとは衝突しない空きスロットの印
+  static constexpr std::uint64_t EMPTY = ~std::uint64_t{0};
+
+  struct alignas(32) entry {
+    std::uint64_t key = EMPTY;
+    char          text[MAC_ADDRESS_STRING_LENGTH]{};
+  };
+  static_assert(sizeof(entry) == 32);
+
+public:
+  /**
+   * @brief キャッシュの統計
+   */
+  struct stats {
+    std::uint64_t hits      = 0;
+    std::uint64_t misses    = 0;
+    std::uint64_t evictions = 0;  ///< ミスのうち、別のMACアドレスが入っていたスロットを置き換えた回数
+
+    [[nodiscard]]
+    auto hit_rate() const noexcept -> double {
+      auto const total = hits + misses;
+      return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+  };
+
+  static constexpr std::size_t memory_footprint = Slots * sizeof(entry);
+
+  mac_string_intern() : table_{std::make_unique<entry[]>(Slots)} {}
+
+  /**
+   * @brief MACアドレスの文字列表現を取得する
+   *
+   * @param mac 48bit整数値（上位16bitは無視される）
+   * @return 整形済みの文字列（スロットが置き換えられるまで有効）
+   */
+  [[nodiscard]]
+  auto operator()(std::uint64_t const mac) -> std::string_view {
+    auto const key = mac & 0xFFFFFFFFFFFFull;
+    auto&      e   = table_[index_of(key)];
+    if (e.key == key) [[likely]] {
+      ++stats_.hits;
+    } else {
+      ++stats_.misses;
+      stats_.evictions += (e.key != EMPTY) ? 1 : 0;
+      format_mac_address_to_buffer<Options>(key, e.text);
+      e.key = key;
+    }
+    return std::string_view{e.text, MAC_ADDRESS_STRING_LENGTH};
+  }
+
+  /**
+   * @brief 整形せずに、キャッシュ済みの文字列があれば返す
+   *
+   * @return キャッシュにない場合は空の `std::string_view`（統計は更新しない）
+   */
+  [[nodiscard]]
+  auto peek(std::uint64_t const mac) const noexcept -> std::string_view {
+    auto const  key = mac & 0xFFFFFFFFFFFFull;
+    auto const& e   = table_[index_of(key)];
+    return (e.key == key) ? std::string_view{e.text, MAC_ADDRESS_STRING_LENGTH} : std::string_view{};
+  }
+
+  [[nodiscard]]
+  auto statistics() const noexcept -> stats const& {
+    return stats_;
+  }
+
+  void reset_statistics() noexcept {
+    stats_ = stats{};
+  }
+
+  /**
+   * @brief 全スロットを空にする（これまでに返した `std::string_view` はすべて無効になる）
+   */
+  void clear() noexcept {
+    for (auto& e : std::span{table_.get(), Slots}) {
+      e.key = EMPTY;
+    }
+  }
+
+private:
+  // フィボナッチハッシュ: 乗算1回で上位bitをスロット番号にする
+  [[nodiscard]]
+  static constexpr auto index_of(std::uint64_t const key) noexcept -> std::size_t {
+    constexpr auto shift = 64 - std::countr_zero(Slots);
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> shift) & (Slots - 1);
+  }
+
+  std::unique_ptr<entry[]> table_;
+  stats                    stats_;
+};
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_INTERN_HPP */
@@ -0,0 +1,71 @@
+#ifndef MACAD_PARSER_IO_HPP
+#define MACAD_PARSER_IO_HPP
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// ファイルに保存するデータ構造（カーネルの選択・行インデックス・MACアドレスのインデックス）が共通で使う内部ヘルパー
+
+namespace macad_parser {
+
+namespace detail {
+  // FNV-1a を8byte単位にしたチェックサム（続きから計算できるように途中の値を受け取る）
+  inline auto checksum(void const* const data, std::size_t const size, std::uint64_t h = 0xCBF29CE484222325ull) noexcept -> std::uint64_t {
+    auto const* const bytes = static_cast<unsigned char const*>(data);
+    auto              i     = std::size_t{0};
+    for (; i + 8 <= size; i += 8) {
+      auto word = std::uint64_t{};
+      std::memcpy(&word, bytes + i, 8);
+      h = (h ^ word) * 0x100000001B3ull;
+    }
+    for (; i < size; ++i) {
+      h = (h ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return h;
+  }
+
+  /**
+   * @brief `write(std::FILE*) -> bool` で一時ファイルに書き込み、成功したら `path` に置き換える
+   *
+   * 一時ファイルは呼び出しごとに名前を変えて排他的に作成するため、同じ `path` に同時に保存する別のプロセス・スレッドと
+   * 書き込みが混ざることはありません（最後に置き換えた方の内容がそのまま残ります）
+   *
+   * @return 書き込めなかった場合は false（一時ファイルは削除し、既存の `path` はそのまま）
+   */
+  template <typename Write>
+  auto replace_file(std::string const& path, Write&& write) -> bool {
+    static auto counter = std::atomic<std::uint64_t>{0};
+
+    auto  tmp = std::string{};
+    auto* fp  = static_cast<std::FILE*>(nullptr);
+    for (auto attempt = 0; attempt < 16 and fp == nullptr; ++attempt) {
+      // 時刻・呼び出し回数・（ASLRで変わる）変数のアドレスを混ぜて、プロセス間でも重なりにくい名前にする
+      auto const now    = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+      auto const unique = (now ^ reinterpret_cast<std::uintptr_t>(&counter)) * 0x9E3779B97F4A7C15ull + counter.fetch_add(1, std::memory_order_relaxed);
+      auto       suffix = std::array<char, 16>{};
+      auto const end    = std::to_chars(suffix.data(), suffix.data() + suffix.size(), unique, 16).ptr;
+      tmp               = path + ".tmp." + std::string{suffix.data(), end};
+      // "x": 既に存在する場合は開かない（別の書き込みと同じ名前を引いたら作り直す）
+      fp = std::fopen(tmp.c_str(), "wbx");
+    }
+    if (fp == nullptr) {
+      return false;
+    }
+    auto const wrote = write(fp);
+    if (std::fclose(fp) != 0 or not wrote or std::rename(tmp.c_str(), path.c_str()) != 0) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+    return true;
+  }
+}  // namespace detail
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_IO_HPP */
@@ -0,0 +1,232 @@
+#ifndef MACAD_PARSER_LAZY_HPP
+#define MACAD_PARSER_LAZY_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+namespace detail {
+  // 比較用の文字列を作るオプション（英字は小文字にそろえる）
+  template <char Delimiter>
+  struct lowercase_options {
+    static constexpr char delimiter = Delimiter;
+    static constexpr bool uppercase = false;
+  };
+}  // namespace detail
+
+/**
+ * @brief MACアドレス文字列がある値を表しているかを、パースせずに文字列のまま判定する
+ *
+ * 比較対象の値を文字列にしたものと、先頭16文字をSIMDで一度に比べます（17文字目は個別に比べる）
+ * 英字の位置だけ入力に 0x20 をORしてから比べるため、大文字・小文字は区別しません
+ * 判定は `parse_mac_address<Options>` の結果が値と等しいかどうかと一致します
+ * （`Options::validate_delimiters` が false ならデリミタの位置は比べない。16進数以外の文字を含む入力は `Options::validate_hex` に関わらず一致しない）
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ */
+template <typename Options = parse_mac_options>
+class mac_text_matcher {
+public:
+  /**
+   * @brief 比較対象の値から構築する
+   *
+   * @param mac 48bitのMACアドレス（上位16bitは無視される）
+   */
+  explicit mac_text_matcher(std::uint64_t const mac) noexcept : mac_{mac & 0xFFFFFFFFFFFFull} {
+    auto text = std::array<char, MAC_ADDRESS_STRING_LENGTH>{};
+    format_mac_address_to_buffer<detail::lowercase_options<detail::delimiter_v<Options>>>(mac_, text);
+
+    auto expected = std::array<char, 16>{};
+    auto fold     = std::array<char, 16>{};
+    auto care     = std::array<char, 16>{};
+    for (auto i = std::size_t{0}; i < 16; ++i) {
+      auto const is_delimiter = (i % 3 == 2);
+      care[i]                 = (not is_delimiter or detail::validate_delimiters_v<Options>) ? static_cast<char>(0xFF) : 0;
+      fold[i]                 = (not is_delimiter and text[i] >= 'a') ? 0x20 : 0;
+      expected[i]             = static_cast<char>(text[i] & care[i]);
+    }
+    expected_  = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(expected.data()));
+    fold_      = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(fold.data()));
+    care_      = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(care.data()));
+    last_      = text[16];
+    last_fold_ = (text[16] >= 'a') ? 0x20 : 0;
+  }
+
+  /**
+   * @brief 文字列が比較対象の値を表しているかを判定する
+   *
+   * @param mac MACアドレス文字列（先頭17文字だけを見る。入力からは17byteしか読まない）
+   */
+  [[nodiscard]]
+  auto matches(std::string_view const mac) const noexcept -> bool {
+    if (mac.size() < MAC_ADDRESS_STRING_LENGTH) {
+      return false;
+    }
+    auto const chunk = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(mac.data()));
+    auto const diff  = simde_mm_xor_si128(simde_mm_and_si128(simde_mm_or_si128(chunk, fold_), care_), expected_);
+    return simde_mm_testz_si128(diff, diff) != 0 and static_cast<char>(mac[16] | last_fold_) == last_;
+  }
+
+  /**
+   * @brief 比較対象の値
+   */
+  [[nodiscard]]
+  auto value() const noexcept -> std::uint64_t {
+    return mac_;
+  }
+
+private:
+  std::uint64_t mac_;
+  simde__m128i  expected_;
+  simde__m128i  fold_;
+  simde__m128i  care_;
+  char          last_;
+  char          last_fold_;
+};
+
+/**
+ * @brief 必要になるまでパースしないMACアドレス文字列への参照
+ *
+ * 文字列は `std::string_view` のまま保持し、最初に値を取り出したときにパースして結果を保持します
+ * 前段のフィルタで大半のレコードが捨てられる処理で、捨てられるレコードのパースを省くために使います
+ * 値との比較は、パース済みなら保持した値で、未パースなら `mac_text_matcher` で文字列のまま行います（比較ではパースしない）
+ * 参照先の文字列は `lazy_mac` より長く生存している必要があります
+ * 結果の保持は同期しないため、1つのオブジェクトを複数スレッドから同時に使うことはできません
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ */
+template <typename Options = parse_mac_options>
+class lazy_mac {
+public:
+  constexpr lazy_mac() noexcept = default;
+
+  /**
+   * @brief MACアドレス文字列から構築する（ここではパースしない）
+   */
+  constexpr explicit lazy_mac(std::string_view const text) noexcept : text_{text} {}
+
+  /**
+   * @brief 参照している文字列
+   */
+  [[nodiscard]]
+  constexpr auto text() const noexcept -> std::string_view {
+    return text_;
+  }
+
+  /**
+   * @brief パース済みかどうか
+   */
+  [[nodiscard]]
+  constexpr auto is_parsed() const noexcept -> bool {
+    return state_ != UNPARSED;
+  }
+
+  /**
+   * @brief 値を取り出す（初回だけパースする）
+   *
+   * @return パースに失敗した場合は std::nullopt
+   */
+  [[nodiscard]]
+  auto value() const noexcept -> std::optional<std::uint64_t> {
+    if (state_ == UNPARSED) {
+      state_ = encode(parse_mac_address<Options>(text_));
+    }
+    return (state_ == INVALID) ? std::nullopt : std::optional{state_};
+  }
+
+  /**
+   * @brief パース結果を外部から設定する（バッチでパースした結果を書き戻す場合など）
+   */
+  constexpr void assign(std::optional<std::uint64_t> const value) noexcept {
+    state_ = encode(value);
+  }
+
+  /**
+   * @brief 値と等しいかを判定する（未パースならパースせずに文字列のまま比べる）
+   */
+  [[nodiscard]]
+  auto operator==(mac_text_matcher<Options> const& target) const noexcept -> bool {
+    return is_parsed() ? state_ == target.value() : target.matches(text_);
+  }
+
+  /**
+   * @brief 値と等しいかを判定する（未パースならパースして結果を保持する）
+   */
+  [[nodiscard]]
+  auto operator==(std::uint64_t const mac) const noexcept -> bool {
+    return value() == mac;
+  }
+
+private:
+  // 48bitの値と重ならない状態値
+  static constexpr std::uint64_t UNPARSED = ~std::uint64_t{0};
+  static constexpr std::uint64_t INVALID  = ~std::uint64_t{0} - 1;
+
+  static constexpr auto encode(std::optional<std::uint64_t> const value) noexcept -> std::uint64_t {
+    return value ? *value : INVALID;
+  }
+
+  std::string_view      text_;
+  // const な `value()` の初回のパースで書き換えるため mutable（それ以外の書き換えは `assign` で行う）
+  mutable std::uint64_t state_ = UNPARSED;
+};
+
+/**
+ * @brief フィルタを通過したレコードだけをまとめてパースする
+ *
+ * `survivors` が指す要素のうち未パースのものの文字列を集め、`parse_mac_addresses` でまとめてパースして結果を書き戻します
+ * パース済みの要素と範囲外の添字は飛ばします
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param records レコードの並び
+ * @param survivors パースする要素の添字の並び（フィルタを通過したレコード）
+ * @return 指定された要素のうち、値を持つ（パースに成功した）要素数
+ */
+template <typename Options = parse_mac_options>
+auto materialize_mac_addresses(std::type_identity_t<std::span<lazy_mac<Options>>> const records, std::span<std::size_t const> const survivors) noexcept -> std::size_t {
+  constexpr auto BATCH = std::size_t{64};
+
+  auto views   = std::array<std::string_view, BATCH>{};
+  auto results = std::array<std::optional<std::uint64_t>, BATCH>{};
+  auto targets = std::array<lazy_mac<Options>*, BATCH>{};
+  auto pending = std::size_t{0};
+  auto valid   = std::size_t{0};
+
+  auto const flush = [&] {
+    parse_mac_addresses<Options>(std::span{views}.first(pending), std::span{results}.first(pending));
+    for (auto i = std::size_t{0}; i < pending; ++i) {
+      targets[i]->assign(results[i]);
+      valid += results[i].has_value() ? 1 : 0;
+    }
+    pending = 0;
+  };
+
+  for (auto const index : survivors) {
+    if (index >= records.size()) {
+      continue;
+    }
+    auto& record = records[index];
+    if (record.is_parsed()) {
+      valid += record.value().has_value() ? 1 : 0;
+      continue;
+    }
+    views[pending]   = record.text();
+    targets[pending] = &record;
+    if (++pending == BATCH) {
+      flush();
+    }
+  }
+  flush();
+  return valid;
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_LAZY_HPP */
@@ -0,0 +1,303 @@
+#ifndef MACAD_PARSER_LINES_HPP
+#define MACAD_PARSER_LINES_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "macad-parser-io.hpp"
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+namespace detail {
+  // 行インデックスファイルの先頭（バージョンを上げたら古いファイルは読み込まない）
+  inline constexpr std::array<char, 8> LINE_INDEX_MAGIC   = {'M', 'A', 'C', 'A', 'D', 'L', 'X', '1'};
+  inline constexpr std::uint32_t       LINE_INDEX_VERSION = 1;
+
+  // テキストの取り違えを検出するために、先頭と末尾のこのバイト数からハッシュを取る
+  inline constexpr std::size_t LINE_INDEX_SAMPLE = 4096;
+
+  struct line_index_header {
+    std::array<char, 8> magic;
+    std::uint32_t       version;
+    std::uint32_t       reserved;
+    std::uint64_t       text_size;
+    std::uint64_t       text_hash;
+    std::uint64_t       lines;
+    std::uint64_t       wraps;
+    std::uint64_t       payload_hash;
+  };
+
+  inline auto sample_text_hash(std::string_view const text) noexcept -> std::uint64_t {
+    auto const head = std::min(text.size(), LINE_INDEX_SAMPLE);
+    auto const tail = std::min(text.size() - head, LINE_INDEX_SAMPLE);
+    return checksum(text.data() + text.size() - tail, tail, checksum(text.data(), head));
+  }
+}  // namespace detail
+
+/**
+ * @brief テキストの各行の先頭位置を保持するインデックス
+ *
+ * 1回の走査で改行を32byteずつベクトル比較して検出し、行の先頭位置を配列に記録します
+ * 位置は下位32bitだけを1行4byteで保持し、4GiBを超えるテキストでは上位が変わる行番号を別に持ちます
+ * 構築後は N 行目の先頭を二分探索なし（4GiB以下の場合）で求められ、行頭のMACアドレスを再走査なしにパースできます
+ * 行の範囲を分けて複数スレッドから同時にパースできます（インデックスは変更しないため同期は不要）
+ * テキスト自体は保持しないため、各メンバ関数には構築に使ったものと同じテキストを渡してください
+ */
+class mac_line_index {
+public:
+  mac_line_index() noexcept = default;
+
+  /**
+   * @brief テキストを1回走査してインデックスを構築する
+   *
+   * 行は '\n' で区切られ、最後の行は改行で終わらなくてもかまいません（改行で終わる場合、その後ろに空の行は数えない）
+   *
+   * @param text 対象のテキスト
+   */
+  [[nodiscard]]
+  static auto build(std::string_view const text) -> mac_line_index {
+    auto index       = mac_line_index{};
+    index.text_size_ = text.size();
+    index.text_hash_ = detail::sample_text_hash(text);
+    if (text.empty()) {
+      return index;
+    }
+    index.low_.reserve(text.size() / 64 + 1);
+    index.low_.push_back(0);
+
+    auto const newline = simde_mm256_set1_epi8('\n');
+    auto const scan    = [&](char const* const chunk, std::size_t const base) {
+      auto mask = static_cast<std::uint32_t>(simde_mm256_movemask_epi8(simde_mm256_cmpeq_epi8(simde_mm256_loadu_si256(reinterpret_cast<simde__m256i const*>(chunk)), newline)));
+      while (mask != 0) {
+        index.push_line(base + static_cast<std::size_t>(std::countr_zero(mask)) + 1);
+        mask &= mask - 1;
+      }
+    };
+
+    auto pos = std::size_t{0};
+    for (; pos + 32 <= text.size(); pos += 32) {
+      scan(text.data() + pos, pos);
+    }
+    // 残りはゼロ埋めバッファにコピーして同じ処理を行う（ゼロは改行にならない）
+    if (pos < text.size()) {
+      auto buf = std::array<char, 32>{};
+      std::memcpy(buf.data(), text.data() + pos, text.size() - pos);
+      scan(buf.data(), pos);
+    }
+    // 末尾の改行の直後は行に数えない
+    if (index.offset(index.low_.size() - 1) == text.size()) {
+      index.low_.pop_back();
+      if (not index.wraps_.empty() and index.wraps_.back() == index.low_.size()) {
+        index.wraps_.pop_back();
+      }
+    }
+    return index;
+  }
+
+  /**
+   * @brief 行数
+   */
+  [[nodiscard]]
+  auto size() const noexcept -> std::size_t {
+    return low_.size();
+  }
+
+  /**
+   * @brief 構築に使ったテキストの長さ
+   */
+  [[nodiscard]]
+  auto text_size() const noexcept -> std::size_t {
+    return text_size_;
+  }
+
+  /**
+   * @brief `n` 行目（0始まり）の先頭のオフセット
+   */
+  [[nodiscard]]
+  auto offset(std::size_t const n) const noexcept -> std::size_t {
+    if (wraps_.empty()) {
+      return low_[n];
+    }
+    auto const high = static_cast<std::size_t>(std::upper_bound(wraps_.begin(), wraps_.end(), n) - wraps_.begin());
+    return (high << 32) | low_[n];
+  }
+
+  /**
+   * @brief `n` 行目の内容（改行を含まない）
+   */
+  [[nodiscard]]
+  auto line(std::string_view const text, std::size_t const n) const noexcept -> std::string_view {
+    auto const begin = offset(n);
+    auto const end   = (n + 1 < size()) ? offset(n + 1) - 1 : text.size() - (text.ends_with('\n') ? 1 : 0);
+    return text.substr(begin, end - begin);
+  }
+
+  /**
+   * @brief `n` 行目の先頭にあるMACアドレスをパースする
+   *
+   * 行頭から32byte読み取れる場合は `parse_mac_address_unsafe` を1回呼ぶだけで、行の終わりを探したりコピーしたりしません
+   * テキストの末尾付近の行だけは `parse_mac_address` でパースします
+   *
+   * @tparam Options パースの仕方を指定するオプション
+   * @param text 構築に使ったテキスト
+   * @param n 行番号（0始まり。`size()` 未満であること）
+   * @return 行が17文字に満たない場合やパースに失敗した場合は std::nullopt
+   */
+  template <typename Options = parse_mac_options>
+  [[nodiscard]]
+  auto parse(std::string_view const text, std::size_t const n) const noexcept -> std::optional<std::uint64_t> {
+    auto const mac = line(text, n);
+    if (mac.data() + 32 <= text.data() + text.size()) {
+      return parse_mac_address_unsafe<Options>(mac);
+    }
+    return parse_mac_address<Options>(mac);
+  }
+
+  /**
+   * @brief 連続する行の先頭にあるMACアドレスをまとめてパースする
+   *
+   * 行の範囲を分ければ、複数スレッドから同じインデックスとテキストで同時に呼べます
+   *
+   * @tparam Options パースの仕方を指定するオプション
+   * @param text 構築に使ったテキスト
+   * @param first 最初の行番号
+   * @param out パース結果の書き込み先（`first` 行目から `out.size()` 行分。範囲外の行には std::nullopt を書く）
+   * @return パースに成功した行数
+   */
+  template <typename Options = parse_mac_options>
+  auto parse_lines(std::string_view const text, std::size_t const first, std::span<std::optional<std::uint64_t>> const out) const noexcept -> std::size_t {
+    auto valid = std::size_t{0};
+    for (auto i = std::size_t{0}; i < out.size(); ++i) {
+      out[i] = (first + i < size()) ? parse<Options>(text, first + i) : std::nullopt;
+      valid += out[i].has_value() ? 1 : 0;
+    }
+    return valid;
+  }
+
+  /**
+   * @brief インデックスをファイルに保存する
+   *
+   * 一時ファイルに書いてから置き換えるため、途中で失敗しても既存のファイルは壊れません
+   * ファイルはこのマシンのバイト順で書きます
+   *
+   * @param path 保存先（例: テキストのパスに ".lix" を付けたもの）
+   * @return 保存できたかどうか
+   */
+  auto save(std::string const& path) const -> bool {
+    auto const wraps  = std::vector<std::uint64_t>(wraps_.begin(), wraps_.end());
+    auto       header = detail::line_index_header{detail::LINE_INDEX_MAGIC, detail::LINE_INDEX_VERSION, 0, text_size_, text_hash_, low_.size(), wraps.size(), payload_hash(wraps)};
+
+    return detail::replace_file(path, [&](std::FILE* const fp) {
+      return std::fwrite(&header, sizeof(header), 1, fp) == 1 and (low_.empty() or std::fwrite(low_.data(), sizeof(std::uint32_t), low_.size(), fp) == low_.size()) and
+             (wraps.empty() or std::fwrite(wraps.data(), sizeof(std::uint64_t), wraps.size(), fp) == wraps.size());
+    });
+  }
+
+  /**
+   * @brief 保存したインデックスを読み込む
+   *
+   * テキストの長さと先頭・末尾4KiBのハッシュが保存時と一致し、内容のチェックサムが合う場合だけ使います
+   * （テキストの中ほどだけが書き換えられた場合は検出できないため、テキストを更新したらインデックスも作り直してください）
+   *
+   * @param path 保存したファイル
+   * @param text インデックスを使うテキスト
+   * @return 読み込めない・壊れている・テキストが変わっている場合は std::nullopt
+   */
+  [[nodiscard]]
+  static auto load(std::string const& path, std::string_view const text) -> std::optional<mac_line_index> {
+    auto* const fp = std::fopen(path.c_str(), "rb");
+    if (fp == nullptr) {
+      return std::nullopt;
+    }
+    auto index  = mac_line_index{};
+    auto header = detail::line_index_header{};
+    auto wraps  = std::vector<std::uint64_t>{};
+    auto ok     = std::fread(&header, sizeof(header), 1, fp) == 1 and header.magic == detail::LINE_INDEX_MAGIC and header.version == detail::LINE_INDEX_VERSION and
+              header.text_size == text.size() and header.text_hash == detail::sample_text_hash(text) and header.lines <= text.size() and header.wraps <= header.lines;
+    if (ok) {
+      index.low_.resize(header.lines);
+      wraps.resize(header.wraps);
+      ok = (index.low_.empty() or std::fread(index.low_.data(), sizeof(std::uint32_t), index.low_.size(), fp) == index.low_.size()) and
+           (wraps.empty() or std::fread(wraps.data(), sizeof(std::uint64_t), wraps.size(), fp) == wraps.size()) and std::fgetc(fp) == EOF;
+    }
+    std::fclose(fp);
+    if (not ok or index.payload_hash(wraps) != header.payload_hash) {
+      return std::nullopt;
+    }
+    index.text_size_ = text.size();
+    index.text_hash_ = header.text_hash;
+    index.wraps_.assign(wraps.begin(), wraps.end());
+    // 行の先頭は狭義の昇順で、最初の行は0から始まり、最後の行はテキストの中で始まる
+    if (not std::ranges::is_sorted(index.wraps_) or not index.ascending() or (not index.low_.empty() and (index.low_[0] != 0 or index.offset(index.size() - 1) >= text.size()))) {
+      return std::nullopt;
+    }
+    return index;
+  }
+
+  /**
+   * @brief 保存したインデックスを読み込み、使えなければ構築して保存する
+   *
+   * @param path インデックスファイル
+   * @param text 対象のテキスト
+   */
+  [[nodiscard]]
+  static auto load_or_build(std::string const& path, std::string_view const text) -> mac_line_index {
+    if (auto loaded = load(path, text)) {
+      return std::move(*loaded);
+    }
+    auto index = build(text);
+    index.save(path);
+    return index;
+  }
+
+private:
+  void push_line(std::size_t const offset) {
+    // 上位32bitが変わった最初の行番号を、変わった回数だけ記録する
+    while ((offset >> 32) > wraps_.size()) {
+      wraps_.push_back(low_.size());
+    }
+    low_.push_back(static_cast<std::uint32_t>(offset));
+  }
+
+  // 各行の先頭が前の行の先頭より後ろにあるか（`wraps_` は昇順であること）
+  [[nodiscard]]
+  auto ascending() const noexcept -> bool {
+    auto high     = std::size_t{0};
+    auto previous = std::size_t{0};
+    for (auto i = std::size_t{0}; i < low_.size(); ++i) {
+      while (high < wraps_.size() and wraps_[high] <= i) {
+        ++high;
+      }
+      auto const current = (high << 32) | low_[i];
+      if (i > 0 and current <= previous) {
+        return false;
+      }
+      previous = current;
+    }
+    return true;
+  }
+
+  auto payload_hash(std::span<std::uint64_t const> const wraps) const noexcept -> std::uint64_t {
+    return detail::checksum(wraps.data(), wraps.size_bytes(), detail::checksum(low_.data(), low_.size() * sizeof(std::uint32_t)));
+  }
+
+  std::vector<std::uint32_t> low_;
+  std::vector<std::size_t>   wraps_;
+  std::uint64_t              text_size_ = 0;
+  std::uint64_t              text_hash_ = 0;
+};
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_LINES_HPP */
@@ -0,0 +1,255 @@
+#ifndef MACAD_PARSER_PADDED_HPP
+#define MACAD_PARSER_PADDED_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief `padded_string` / `padded_string_view` が末尾の後ろに保証する読み取り可能なバイト数
+ *
+ * `parse_mac_address_unsafe` が1回にロードする32byteと同じ大きさです
+ */
+inline constexpr std::size_t MAC_ADDRESS_PADDING = 32;
+
+/**
+ * @brief 末尾の後ろに `MAC_ADDRESS_PADDING` バイト以上の読み取り可能な領域があることを保証した文字列ビュー
+ *
+ * 部分文字列（`substr`）も元の領域の中に収まるため、同じ保証を持ちます
+ * `std::string_view` へは暗黙に変換できます
+ */
+class padded_string_view {
+public:
+  padded_string_view() noexcept = default;
+
+  /**
+   * @brief 任意の領域から作る
+   *
+   * @param data 文字列の先頭
+   * @param size 文字列の長さ
+   * @param capacity `data` から読み取れるバイト数（`size + MAC_ADDRESS_PADDING` に満たない場合は、パディングが確保できる長さに `size` を切り詰める）
+   */
+  padded_string_view(char const* const data, std::size_t const size, std::size_t const capacity) noexcept
+    : data_{data}, size_{clamp_size(size, capacity)} {}
+
+  [[nodiscard]]
+  auto data() const noexcept -> char const* {
+    return data_;
+  }
+
+  [[nodiscard]]
+  auto size() const noexcept -> std::size_t {
+    return size_;
+  }
+
+  [[nodiscard]]
+  auto empty() const noexcept -> bool {
+    return size_ == 0;
+  }
+
+  /**
+   * @brief 部分文字列を返す（`pos` が範囲外の場合は空のビュー）
+   */
+  [[nodiscard]]
+  auto substr(std::size_t const pos, std::size_t const count = std::string_view::npos) const noexcept -> padded_string_view {
+    if (pos >= size_) {
+      return padded_string_view{data_ + size_, 0};
+    }
+    auto const rest = size_ - pos;
+    return padded_string_view{data_ + pos, count < rest ? count : rest};
+  }
+
+  operator std::string_view() const noexcept {
+    return std::string_view{data_, size_};
+  }
+
+private:
+  padded_string_view(char const* const data, std::size_t const size) noexcept : data_{data}, size_{size} {}
+
+  [[nodiscard]]
+  static constexpr auto clamp_size(std::size_t const size, std::size_t const capacity) noexcept -> std::size_t {
+    if (capacity < MAC_ADDRESS_PADDING) {
+      return 0;
+    }
+    return (size < capacity - MAC_ADDRESS_PADDING) ? size : capacity - MAC_ADDRESS_PADDING;
+  }
+
+  char const* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+/**
+ * @brief 末尾の後ろに `MAC_ADDRESS_PADDING` バイトのゼロ埋め領域を持つ文字列
+ *
+ * 領域はキャッシュライン（64byte）境界に揃えて確保します
+ * `padded_string_view` に変換して `parse_mac_address` に渡すと、コピーせずに `parse_mac_address_unsafe` で直接パースします
+ */
+class padded_string {
+public:
+  static constexpr std::size_t ALIGNMENT = 64;
+
+  padded_string() noexcept = default;
+
+  /**
+   * @brief ゼロで埋めた `size` バイトの文字列を作る
+   */
+  explicit padded_string(std::size_t const size) : data_{allocate(size)}, size_{size} {}
+
+  /**
+   * @brief `text` をコピーして作る
+   */
+  explicit padded_string(std::string_view const text) : padded_string{text.size()} {
+    std::memcpy(data_, text.data(), text.size());
+  }
+
+  padded_string(padded_string const& other) : padded_string{std::string_view{other.data(), other.size()}} {}
+
+  padded_string(padded_string&& other) noexcept : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} {}
+
+  auto operator=(padded_string const& other) -> padded_string& {
+    if (this != &other) {
+      *this = padded_string{other};
+    }
+    return *this;
+  }
+
+  auto operator=(padded_string&& other) noexcept -> padded_string& {
+    if (this != &other) {
+      deallocate(data_);
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~padded_string() {
+    deallocate(data_);
+  }
+
+  [[nodiscard]]
+  auto data() noexcept -> char* {
+    return data_;
+  }
+
+  [[nodiscard]]
+  auto data() const noexcept -> char const* {
+    return data_;
+  }
+
+  [[nodiscard]]
+  auto size() const noexcept -> std::size_t {
+    return size_;
+  }
+
+  [[nodiscard]]
+  auto empty() const noexcept -> bool {
+    return size_ == 0;
+  }
+
+  [[nodiscard]]
+  auto view() const noexcept -> padded_string_view {
+    return padded_string_view{data_, size_, size_ + MAC_ADDRESS_PADDING};
+  }
+
+  operator padded_string_view() const noexcept {
+    return view();
+  }
+
+  /**
+   * @brief ファイルの内容をすべて読み込む
+   *
+   * @return 開けなかった場合や読み込みに失敗した場合は `std::nullopt`
+   */
+  [[nodiscard]]
+  static auto load(std::string const& path) -> std::optional<padded_string> {
+    auto* const fp = std::fopen(path.c_str(), "rb");
+    if (fp == nullptr) {
+      return std::nullopt;
+    }
+    auto result = read(fp);
+    std::fclose(fp);
+    return result;
+  }
+
+  /**
+   * @brief `FILE*` の現在の位置から終端までを読み込む（標準入力やパイプも可）
+   *
+   * @return 読み込みに失敗した場合は `std::nullopt`
+   */
+  [[nodiscard]]
+  static auto read(std::FILE* const fp) -> std::optional<padded_string> {
+    // 残りのサイズが分かる場合は1回の確保で読み切れるようにする（+1 は終端の検出用）
+    auto       capacity = std::size_t{1} << 16;
+    auto const current  = std::ftell(fp);
+    if (current >= 0 and std::fseek(fp, 0, SEEK_END) == 0) {
+      auto const end = std::ftell(fp);
+      if (std::fseek(fp, current, SEEK_SET) == 0 and end >= current) {
+        capacity = static_cast<std::size_t>(end - current) + 1;
+      }
+    }
+
+    auto buffer = padded_string{capacity};
+    auto filled = std::size_t{0};
+    while (true) {
+      filled += std::fread(buffer.data_ + filled, 1, buffer.size_ - filled, fp);
+      if (filled < buffer.size_) {
+        break;
+      }
+      auto larger = padded_string{buffer.size_ * 2};
+      std::memcpy(larger.data_, buffer.data_, filled);
+      buffer = std::move(larger);
+    }
+    if (std::ferror(fp) != 0) {
+      return std::nullopt;
+    }
+    // 確保済みの領域を縮めるだけなので、末尾の後ろは引き続きゼロ埋めされている
+    buffer.size_ = filled;
+    return buffer;
+  }
+
+private:
+  [[nodiscard]]
+  static auto allocate(std::size_t const size) -> char* {
+    auto const bytes = (size + MAC_ADDRESS_PADDING + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    auto*      data  = static_cast<char*>(::operator new(bytes, std::align_val_t{ALIGNMENT}));
+    std::memset(data, 0, bytes);
+    return data;
+  }
+
+  static void deallocate(char* const data) noexcept {
+    if (data != nullptr) {
+      ::operator delete(data, std::align_val_t{ALIGNMENT});
+    }
+  }
+
+  char*       data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+/**
+ * @brief 末尾にパディングのある文字列をパースする
+ *
+ * 32byteのロードが範囲外に出ないことが型で保証されているため、コピーせずに `parse_mac_address_unsafe` を呼びます
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param mac パース対象のMACアドレス文字列 (例: "AA:BB:CC:DD:EE:FF")
+ * @return std::optional<std::uint64_t>
+ */
+template <typename Options = parse_mac_options>
+[[nodiscard]]
+auto parse_mac_address(padded_string_view const mac) noexcept -> std::optional<std::uint64_t> {
+  return parse_mac_address_unsafe<Options>(mac);
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_PADDED_HPP */
@@ -0,0 +1,299 @@
+#ifndef MACAD_PARSER_PIPELINE_HPP
+#define MACAD_PARSER_PIPELINE_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "macad-parser.hpp"
+#include "macad-parser-stream.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief 生産者1スレッド・消費者1スレッド用のロックフリーなリングバッファ
+ *
+ * 読み位置と書き位置は別々のキャッシュラインに置き、相手側の位置はキャッシュしておいて
+ * 満杯/空に見えたときだけ読み直すことで、キャッシュラインの往復を減らします
+ *
+ * @tparam T 要素の型（ムーブ可能であること）
+ */
+template <typename T>
+class spsc_ring {
+public:
+  /**
+   * @param capacity 最低限必要な要素数（2のべき乗へ切り上げる）
+   */
+  explicit spsc_ring(std::size_t const capacity)
+    : mask_{std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1}, slots_{std::make_unique<std::optional<T>[]>(mask_ + 1)} {}
+
+  /**
+   * @brief 要素を追加する（生産者スレッドからのみ呼ぶ）
+   *
+   * @return 満杯で追加できなかった場合は false（`value` はムーブされない）
+   */
+  auto try_push(T& value) -> bool {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ > mask_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ > mask_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_].emplace(std::move(value));
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 要素を取り出す（消費者スレッドからのみ呼ぶ）
+   *
+   * @return 空の場合は `std::nullopt`
+   */
+  auto try_pop() -> std::optional<T> {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return std::nullopt;
+      }
+    }
+    auto& slot  = slots_[head & mask_];
+    auto  value = std::move(slot);
+    slot.reset();
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  /**
+   * @brief 生産者がこれ以上追加しないことを知らせる（生産者スレッドからのみ呼ぶ）
+   */
+  void close() noexcept {
+    closed_.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief 生産者が `close()` 済みで、かつ空かどうか（消費者スレッドからのみ呼ぶ）
+   */
+  [[nodiscard]]
+  auto drained() noexcept -> bool {
+    if (not closed_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]]
+  auto capacity() const noexcept -> std::size_t {
+    return mask_ + 1;
+  }
+
+private:
+  std::size_t                          mask_;
+  std::unique_ptr<std::optional<T>[]> slots_;
+
+  alignas(64) std::atomic<std::size_t> head_{0};
+  std::size_t tail_cache_ = 0;
+
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  std::size_t head_cache_ = 0;
+
+  alignas(64) std::atomic<bool> closed_{false};
+};
+
+/**
+ * @brief パイプラインの1ステージの計測結果
+ */
+struct stage_metrics {
+  std::uint64_t            items = 0;  ///< 処理した単位数（チャンクまたはバッチ）
+  std::uint64_t            bytes = 0;  ///< 処理したバイト数（読み込み/パースのステージのみ）
+  std::chrono::nanoseconds busy{0};    ///< 処理そのものに費やした時間
+  std::chrono::nanoseconds wait{0};    ///< 入力待ち・出力待ち（バックプレッシャー）の時間
+
+  /**
+   * @brief 稼働率（処理時間 / (処理時間 + 待ち時間)）
+   */
+  [[nodiscard]]
+  auto utilization() const noexcept -> double {
+    auto const total = busy + wait;
+    return total.count() == 0 ? 0.0 : static_cast<double>(busy.count()) / static_cast<double>(total.count());
+  }
+};
+
+/**
+ * @brief パイプライン全体の計測結果
+ */
+struct pipeline_metrics {
+  stage_metrics read;
+  stage_metrics parse;
+  stage_metrics aggregate;
+  std::uint64_t macs = 0;
+};
+
+/**
+ * @brief パイプラインの設定
+ */
+struct pipeline_config {
+  std::size_t        chunk_size    = std::size_t{1} << 20;  ///< 読み込みステージが1回に読むバイト数
+  std::size_t        ring_capacity = 8;                     ///< ステージ間のリングバッファの要素数
+  std::array<int, 3> cpus          = {-1, -1, -1};          ///< 読み込み/パース/集計ステージを固定するCPU番号（-1で固定しない）
+};
+
+namespace detail {
+  // 現在のスレッドを指定したCPUに固定する（Linux以外では何もしない）
+  inline void pin_current_thread(int const cpu) noexcept {
+#if defined(__linux__)
+    if (cpu >= 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#else
+    static_cast<void>(cpu);
+#endif
+  }
+
+  // リングに追加できるまで待つ（待った時間を返す）
+  template <typename T>
+  auto push_blocking(spsc_ring<T>& ring, T& value) -> std::chrono::nanoseconds {
+    if (ring.try_push(value)) {
+      return std::chrono::nanoseconds{0};
+    }
+    auto const start = std::chrono::steady_clock::now();
+    while (not ring.try_push(value)) {
+      std::this_thread::yield();
+    }
+    return std::chrono::steady_clock::now() - start;
+  }
+
+  // リングから取り出せるまで待つ（閉じられて空なら nullopt）
+  template <typename T>
+  auto pop_blocking(spsc_ring<T>& ring, std::chrono::nanoseconds& waited) -> std::optional<T> {
+    auto const start = std::chrono::steady_clock::now();
+    while (true) {
+      if (auto v = ring.try_pop()) {
+        waited += std::chrono::steady_clock::now() - start;
+        return v;
+      }
+      if (ring.drained()) {
+        // close() 直前に追加された要素を取りこぼさないよう、もう一度だけ取り出しを試す
+        auto v = ring.try_pop();
+        waited += std::chrono::steady_clock::now() - start;
+        return v;
+      }
+      std::this_thread::yield();
+    }
+  }
+}  // namespace detail
+
+/**
+ * @brief 読み込み → パース → 集計 の3ステージを別スレッドで並行に動かすパイプライン
+ *
+ * ステージ間は `spsc_ring` でつなぎ、リングが満杯になると上流のステージが待つ（バックプレッシャー）
+ * 読み込み先のバッファは最初に確保したものを使い回し、パースを終えたバッファは別のリングで読み込みステージに返す
+ * パースステージは `mac_stream_scanner` でチャンク中のMACアドレスをまとめて取り出し、バッチとして集計ステージに渡す
+ * チャンクの末尾で途切れたMACアドレスの候補はスキャナが次のチャンクに持ち越すため、改行のない入力や
+ * `chunk_size` より長い行でも、入力全体を `scan_mac_addresses` で走査した場合と同じMACアドレスが得られます
+ *
+ * @tparam Options デリミタを指定するオプション（`mac_stream_scanner` に渡す）
+ * @param read `read(std::span<char> buffer) -> std::size_t` の形で呼ばれ、読み込んだバイト数を返す（0で終端）
+ * @param aggregate `aggregate(std::span<std::uint64_t const> macs)` の形で集計スレッドから呼ばれる
+ * @param config パイプラインの設定
+ * @return 各ステージの計測結果
+ */
+template <typename Options = parse_mac_options, typename Read, typename Aggregate>
+auto run_mac_pipeline(Read&& read, Aggregate&& aggregate, pipeline_config const& config = {}) -> pipeline_metrics {
+  using clock = std::chrono::steady_clock;
+
+  auto chunks  = spsc_ring<std::string>{config.ring_capacity};
+  auto batches = spsc_ring<std::vector<std::uint64_t>>{config.ring_capacity};
+  auto metrics = pipeline_metrics{};
+
+  // 読み込み先のバッファは使い回す（リングに入る分と、読み込み中・パース中の2つ）
+  // パースを終えたバッファは free_chunks で読み込みステージに返す
+  auto const buffers     = chunks.capacity() + 2;
+  auto       free_chunks = spsc_ring<std::string>{buffers};
+  for (auto i = std::size_t{0}; i < buffers; ++i) {
+    auto chunk = std::string{};
+    chunk.reserve(config.chunk_size);
+    free_chunks.try_push(chunk);
+  }
+
+  auto reader = std::jthread{[&] {
+    detail::pin_current_thread(config.cpus[0]);
+    while (auto chunk = detail::pop_blocking(free_chunks, metrics.read.wait)) {
+      auto const start = clock::now();
+      auto       n     = std::size_t{0};
+      // 確保済みの領域にそのまま読み込む（ゼロ埋めしない）
+      chunk->resize_and_overwrite(config.chunk_size, [&](char* const data, std::size_t const size) {
+        n = read(std::span<char>{data, size});
+        return n;
+      });
+      if (n == 0) {
+        metrics.read.busy += clock::now() - start;
+        break;
+      }
+      metrics.read.bytes += n;
+      ++metrics.read.items;
+      metrics.read.busy += clock::now() - start;
+      metrics.read.wait += detail::push_blocking(chunks, *chunk);
+    }
+    chunks.close();
+  }};
+
+  auto parser = std::jthread{[&] {
+    detail::pin_current_thread(config.cpus[1]);
+    auto scanner = mac_stream_scanner<Options>{};
+    while (auto chunk = detail::pop_blocking(chunks, metrics.parse.wait)) {
+      auto const start = clock::now();
+      auto       batch = std::vector<std::uint64_t>{};
+      batch.reserve(chunk->size() / (MAC_ADDRESS_STRING_LENGTH + 1));
+      scanner.feed(std::span<char const>{*chunk}, [&](std::size_t, std::uint64_t const value) { batch.push_back(value); });
+      metrics.parse.bytes += chunk->size();
+      ++metrics.parse.items;
+      metrics.parse.busy += clock::now() - start;
+      free_chunks.try_push(*chunk);
+      metrics.parse.wait += detail::push_blocking(batches, batch);
+    }
+    batches.close();
+  }};
+
+  {
+    auto aggregator = std::jthread{[&] {
+      detail::pin_current_thread(config.cpus[2]);
+      while (auto batch = detail::pop_blocking(batches, metrics.aggregate.wait)) {
+        auto const start = clock::now();
+        aggregate(std::span<std::uint64_t const>{*batch});
+        metrics.macs += batch->size();
+        ++metrics.aggregate.items;
+        metrics.aggregate.busy += clock::now() - start;
+      }
+    }};
+  }
+  parser.join();
+  reader.join();
+
+  return metrics;
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_PIPELINE_HPP */
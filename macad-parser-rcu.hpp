@@ -0,0 +1,223 @@
+#ifndef MACAD_PARSER_RCU_HPP
+#define MACAD_PARSER_RCU_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace macad_parser {
+
+/**
+ * @brief 参照スレッドの静止状態（quiescent state）を集計するエポック管理
+ *
+ * 参照スレッドは `register_reader` で取得した `reader` を保持し、参照の合間（例: 1リクエストの処理後）に
+ * `reader::quiescent()` を呼んで「古いスナップショットをもう参照していない」ことを知らせます
+ * `quiescent()` はグローバルエポックの読み込みと自スロットへの書き込みだけで、RMW命令もロックも使いません
+ * 各スロットはキャッシュライン単位で分離しているため、参照スレッド同士で書き込みが衝突しません
+ */
+class rcu_domain {
+  static constexpr std::uint64_t OFFLINE = std::numeric_limits<std::uint64_t>::max();
+
+  struct alignas(64) reader_slot {
+    std::atomic<std::uint64_t> epoch{OFFLINE};
+    std::atomic<bool>          in_use{false};
+  };
+
+public:
+  /**
+   * @brief 参照スレッドの登録（スレッドごとに1つ保持し、そのスレッドからのみ使う）
+   */
+  class reader {
+  public:
+    reader(reader&& other) noexcept : domain_{std::exchange(other.domain_, nullptr)}, slot_{std::exchange(other.slot_, nullptr)} {}
+    reader(reader const&)                    = delete;
+    auto operator=(reader const&) -> reader& = delete;
+    auto operator=(reader&&) -> reader&      = delete;
+
+    ~reader() {
+      if (slot_ != nullptr) {
+        slot_->epoch.store(OFFLINE, std::memory_order_release);
+        slot_->in_use.store(false, std::memory_order_release);
+      }
+    }
+
+    /**
+     * @brief これより前に読んだスナップショットをもう参照していないことを知らせる
+     */
+    void quiescent() noexcept {
+      slot_->epoch.store(domain_->epoch_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    /**
+     * @brief しばらく参照しない（ブロックする処理の前など）。再開時は `quiescent()` を呼ぶ
+     */
+    void offline() noexcept {
+      slot_->epoch.store(OFFLINE, std::memory_order_release);
+    }
+
+  private:
+    friend class rcu_domain;
+
+    reader(rcu_domain* const domain, reader_slot* const slot) noexcept : domain_{domain}, slot_{slot} {
+      quiescent();
+    }
+
+    rcu_domain*  domain_;
+    reader_slot* slot_;
+  };
+
+  /**
+   * @param max_readers 同時に登録できる参照スレッドの最大数
+   */
+  explicit rcu_domain(std::size_t const max_readers = 256) : slots_{std::make_unique<reader_slot[]>(max_readers)}, max_readers_{max_readers} {}
+
+  /**
+   * @brief 参照スレッドを登録する
+   *
+   * @return 登録できなかった場合（最大数に達している場合）は `std::nullopt`
+   */
+  [[nodiscard]]
+  auto register_reader() noexcept -> std::optional<reader> {
+    for (auto i = std::size_t{0}; i < max_readers_; ++i) {
+      auto expected = false;
+      if (slots_[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return reader{this, &slots_[i]};
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief エポックを1つ進め、進める前のエポックを返す
+   *
+   * 返り値のエポックで退避したオブジェクトは、全参照スレッドがそれより新しいエポックで
+   * `quiescent()` を呼んだ（またはオフラインになった）時点で解放できる
+   */
+  auto advance() noexcept -> std::uint64_t {
+    return epoch_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @brief オンラインの参照スレッドが報告した最も古いエポックを返す
+   */
+  [[nodiscard]]
+  auto oldest_reader_epoch() const noexcept -> std::uint64_t {
+    auto oldest = OFFLINE;
+    for (auto i = std::size_t{0}; i < max_readers_; ++i) {
+      auto const e = slots_[i].epoch.load(std::memory_order_acquire);
+      oldest       = (e < oldest) ? e : oldest;
+    }
+    return oldest;
+  }
+
+private:
+  alignas(64) std::atomic<std::uint64_t> epoch_{1};
+  std::unique_ptr<reader_slot[]> slots_;
+  std::size_t                    max_readers_;
+};
+
+/**
+ * @brief 参照スレッドがロックなしで読めるスナップショット（OUIテーブルやルール集合など）の保持者
+ *
+ * 新しい版は任意のスレッド（通常は参照スレッドとは別の更新スレッド）で構築し、`publish` で差し替えます
+ * 差し替えで退避した古い版は、全参照スレッドが静止状態を通過した後（猶予期間の経過後）に `reclaim` で解放されます
+ *
+ * 参照スレッドの典型的な使い方:
+ * @code
+ * auto r = domain.register_reader().value();
+ * while (running) {
+ *   auto const& table = snapshot.read();  // 次の quiescent() まで有効
+ *   ...
+ *   r.quiescent();
+ * }
+ * @endcode
+ *
+ * @tparam T スナップショットの型（構築後は変更しない）
+ */
+template <typename T>
+class rcu_snapshot {
+public:
+  rcu_snapshot(rcu_domain& domain, std::unique_ptr<T const> initial) : domain_{domain}, current_{initial.release()} {}
+
+  rcu_snapshot(rcu_snapshot const&)                    = delete;
+  auto operator=(rcu_snapshot const&) -> rcu_snapshot& = delete;
+
+  // 破棄時には参照スレッドがいないこと
+  ~rcu_snapshot() {
+    delete current_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 現在の版を参照する（acquireロード1回のみ）
+   *
+   * 返された参照は、呼び出したスレッドが次に `quiescent()` / `offline()` を呼ぶまで有効
+   */
+  [[nodiscard]]
+  auto read() const noexcept -> T const& {
+    return *current_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 新しい版に差し替え、古い版を退避する
+   *
+   * @param next 構築済みの新しい版
+   * @return 退避中（まだ解放されていない）古い版の数
+   */
+  auto publish(std::unique_ptr<T const> next) -> std::size_t {
+    auto const lock = std::scoped_lock{mutex_};
+    auto*      old  = current_.exchange(next.release(), std::memory_order_acq_rel);
+    retired_.emplace_back(domain_.advance(), std::unique_ptr<T const>{old});
+    return retired_.size();
+  }
+
+  /**
+   * @brief 現在の版を元に新しい版を作って差し替える
+   *
+   * @param f `f(T const& current) -> std::unique_ptr<T const>` の形で呼ばれる
+   */
+  template <typename F>
+  auto update(F&& f) -> std::size_t {
+    // 更新スレッドは参照スレッドとして登録されていないため、構築中に元の版が reclaim で解放されないよう
+    // reclaim と排他にする（参照スレッドは一切待たされない）
+    auto const lock = std::scoped_lock{update_mutex_};
+    return publish(f(*current_.load(std::memory_order_acquire)));
+  }
+
+  /**
+   * @brief 猶予期間を過ぎた古い版を解放する
+   *
+   * @return 解放した版の数
+   */
+  auto reclaim() -> std::size_t {
+    auto const lock   = std::scoped_lock{update_mutex_, mutex_};
+    auto const oldest = domain_.oldest_reader_epoch();
+    auto const before = retired_.size();
+    std::erase_if(retired_, [&](auto const& entry) { return entry.first < oldest; });
+    return before - retired_.size();
+  }
+
+  /**
+   * @brief まだ解放されていない古い版の数
+   */
+  [[nodiscard]]
+  auto retired() const -> std::size_t {
+    auto const lock = std::scoped_lock{mutex_};
+    return retired_.size();
+  }
+
+private:
+  rcu_domain&                                                     domain_;
+  std::atomic<T const*>                                           current_;
+  mutable std::mutex                                              mutex_;
+  std::mutex                                                      update_mutex_;
+  std::vector<std::pair<std::uint64_t, std::unique_ptr<T const>>> retired_;
+};
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_RCU_HPP */
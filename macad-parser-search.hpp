@@ -0,0 +1,206 @@
+#ifndef MACAD_PARSER_SEARCH_HPP
+#define MACAD_PARSER_SEARCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "macad-parser-table.hpp"
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief テキスト検索で照合する対象のMACアドレスの集合（ウォッチリスト）
+ *
+ * 照合はブロック化Bloomフィルタ（1要素につき64bitの1語だけを読む）で大半の非該当を落とし、
+ * 残りだけを線形探索のハッシュ集合で確定します。構築後は変更できず、複数スレッドから同時に照合できます
+ */
+class mac_watchlist {
+public:
+  /**
+   * @brief 対象のMACアドレスの並びから構築する
+   *
+   * @param targets 48bitのMACアドレスの並び（上位16bitは無視される。重複してもよい）
+   */
+  explicit mac_watchlist(std::span<std::uint64_t const> const targets)
+    : bloom_(std::bit_ceil(std::max<std::size_t>(targets.size() / BLOOM_KEYS_PER_WORD, 1)))
+    , slots_(std::bit_ceil(std::max<std::size_t>(targets.size() * 2, 2)), EMPTY) {
+    for (auto const target : targets) {
+      auto const mac  = target & MAC_MASK;
+      auto const hash = detail::mix_mac_address(mac);
+      bloom_[hash & (bloom_.size() - 1)] |= bloom_bits(hash);
+
+      auto idx = static_cast<std::size_t>(hash) & (slots_.size() - 1);
+      while (slots_[idx] != EMPTY and slots_[idx] != mac) {
+        idx = (idx + 1) & (slots_.size() - 1);
+      }
+      size_ += (slots_[idx] == EMPTY) ? 1 : 0;
+      slots_[idx] = mac;
+    }
+  }
+
+  /**
+   * @brief MACアドレスが含まれているかを判定する
+   */
+  [[nodiscard]]
+  auto contains(std::uint64_t const mac) const noexcept -> bool {
+    auto const key  = mac & MAC_MASK;
+    auto const hash = detail::mix_mac_address(key);
+    auto const bits = bloom_bits(hash);
+    if ((bloom_[hash & (bloom_.size() - 1)] & bits) != bits) {
+      return false;
+    }
+    for (auto idx = static_cast<std::size_t>(hash) & (slots_.size() - 1);; idx = (idx + 1) & (slots_.size() - 1)) {
+      if (slots_[idx] == key) {
+        return true;
+      }
+      if (slots_[idx] == EMPTY) {
+        return false;
+      }
+    }
+  }
+
+  /**
+   * @brief 含まれているMACアドレスの数（重複を除く）
+   */
+  [[nodiscard]]
+  auto size() const noexcept -> std::size_t {
+    return size_;
+  }
+
+private:
+  static constexpr std::uint64_t MAC_MASK = 0xFFFFFFFFFFFFull;
+  static constexpr std::uint64_t EMPTY    = ~std::uint64_t{0};
+
+  // Bloomフィルタの1語（64bit）あたりの要素数の目安（1要素あたり16〜32bit）
+  static constexpr std::size_t BLOOM_KEYS_PER_WORD = 4;
+
+  // 1要素につき同じ語の中の3bitを立てる（語の選択にはハッシュの下位bitを使うため、上位bitから選ぶ）
+  [[nodiscard]]
+  static constexpr auto bloom_bits(std::uint64_t const hash) noexcept -> std::uint64_t {
+    return (std::uint64_t{1} << ((hash >> 40) & 63)) | (std::uint64_t{1} << ((hash >> 46) & 63)) | (std::uint64_t{1} << ((hash >> 52) & 63));
+  }
+
+  std::vector<std::uint64_t> bloom_;
+  std::vector<std::uint64_t> slots_;
+  std::size_t                size_ = 0;
+};
+
+namespace detail {
+  struct watchlist_hit {
+    std::size_t   offset;
+    std::uint64_t mac;
+  };
+
+  /**
+   * @brief 1ウィンドウ分（先頭候補16箇所）を走査し、ウォッチリストに含まれる最初のMACアドレスを返す
+   *
+   * ':' と '-' の両方のデリミタで候補を求める。`window` から `scan_window_readable` バイトが読み取り可能である必要がある
+   */
+  inline auto search_window(char const* const window, std::size_t const base, std::size_t& next, mac_watchlist const& watchlist) -> std::optional<watchlist_hit> {
+    auto const chunk  = simde_mm256_loadu_si256(reinterpret_cast<simde__m256i const*>(window));
+    auto const colon  = static_cast<std::uint32_t>(simde_mm256_movemask_epi8(simde_mm256_cmpeq_epi8(chunk, simde_mm256_set1_epi8(':'))));
+    auto const hyphen = static_cast<std::uint32_t>(simde_mm256_movemask_epi8(simde_mm256_cmpeq_epi8(chunk, simde_mm256_set1_epi8('-'))));
+    auto       cand   = mac_candidate_mask(colon) | mac_candidate_mask(hyphen);
+
+    while (cand != 0) {
+      auto const s = static_cast<std::size_t>(std::countr_zero(cand));
+      cand &= cand - 1;
+      if (base + s < next) {
+        continue;
+      }
+      // デリミタの位置は候補検出の時点で確定しているため、確定時にはデリミタを検証しない
+      auto const v = parse_mac_address_unsafe<scan_confirm_options<':'>>(std::string_view{window + s, MAC_ADDRESS_STRING_LENGTH});
+      if (not v) {
+        continue;
+      }
+      next = base + s + MAC_ADDRESS_STRING_LENGTH;
+      if (watchlist.contains(*v)) {
+        return watchlist_hit{base + s, *v};
+      }
+    }
+    return std::nullopt;
+  }
+}  // namespace detail
+
+/**
+ * @brief ウォッチリストに含まれるMACアドレスを含む行をテキストから探す
+ *
+ * `scan_mac_addresses` と同じ方法で候補を求め、`parse_mac_address_unsafe` で確定した値をウォッチリストと照合します
+ * デリミタは ':' と '-' のどちらも受け付け、16進数の大文字・小文字は区別しません
+ * 1行に複数のMACアドレスが該当しても呼び出しは1回で、該当した行の残りは走査しません
+ * 行の先頭は該当したときだけ直前の改行を逆向きに探して求めるため、該当しない行には改行の検出の手間もかかりません
+ *
+ * @param text 走査対象のテキスト（行は '\n' で区切られている）
+ * @param watchlist 照合するMACアドレスの集合
+ * @param on_line 該当する行ごとに `on_line(std::size_t line_offset, std::size_t match_offset, std::uint64_t mac)` の形で呼ばれる
+ * @return 該当した行の数
+ */
+template <typename F>
+auto search_mac_watchlist(std::string_view const text, mac_watchlist const& watchlist, F&& on_line) -> std::size_t {
+  auto lines = std::size_t{0};
+  auto next  = std::size_t{0};
+  // これより前に該当する行の先頭はない（直前に該当した行の終わり）
+  auto floor = std::size_t{0};
+
+  // 該当した行を報告し、次の行の先頭（走査を再開する位置）を返す
+  auto const report = [&](detail::watchlist_hit const hit) -> std::size_t {
+    auto const newline = text.substr(floor, hit.offset - floor).rfind('\n');
+    auto const line    = (newline == std::string_view::npos) ? floor : floor + newline + 1;
+    auto const end     = text.find('\n', hit.offset + MAC_ADDRESS_STRING_LENGTH);
+    on_line(line, hit.offset, hit.mac);
+    ++lines;
+    floor = next = (end == std::string_view::npos) ? text.size() : end + 1;
+    return floor;
+  };
+
+  auto pos = std::size_t{0};
+  while (pos + detail::scan_window_readable <= text.size()) {
+    if (auto const hit = detail::search_window(text.data() + pos, pos, next, watchlist)) {
+      pos = report(*hit);
+    } else {
+      pos += detail::scan_window_step;
+    }
+  }
+
+  // 残りは読み取り可能なゼロ埋めバッファにコピーして同じ処理を行う
+  if (pos < text.size()) {
+    auto       buf  = std::array<char, detail::scan_window_readable * 2>{};
+    auto const rest = text.size() - pos;
+    std::memcpy(buf.data(), text.data() + pos, rest);
+    for (auto local = std::size_t{0}; local < rest;) {
+      if (auto const hit = detail::search_window(buf.data() + local, pos + local, next, watchlist)) {
+        local = report(*hit) - pos;
+      } else {
+        local += detail::scan_window_step;
+      }
+    }
+  }
+
+  return lines;
+}
+
+/**
+ * @brief ウォッチリストに含まれるMACアドレスを含む行の先頭位置を返す
+ *
+ * @param text 走査対象のテキスト
+ * @param watchlist 照合するMACアドレスの集合
+ * @return 該当した行の先頭のオフセット（昇順）
+ */
+[[nodiscard]]
+inline auto search_mac_watchlist(std::string_view const text, mac_watchlist const& watchlist) -> std::vector<std::size_t> {
+  auto offsets = std::vector<std::size_t>{};
+  search_mac_watchlist(text, watchlist, [&](std::size_t const line, std::size_t, std::uint64_t) { offsets.push_back(line); });
+  return offsets;
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_SEARCH_HPP */
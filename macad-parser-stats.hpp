@@ -0,0 +1,167 @@
+#ifndef MACAD_PARSER_STATS_HPP
+#define MACAD_PARSER_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief `thread_local_mac_stats` の集計結果
+ */
+struct mac_stats_snapshot {
+  static constexpr std::size_t STATUS_COUNT = 4;
+  static constexpr std::size_t KERNEL_COUNT = 3;
+
+  /// `parsed[status][kernel]` は、その結果・処理で終わったパースの回数
+  std::array<std::array<std::uint64_t, KERNEL_COUNT>, STATUS_COUNT> parsed{};
+  std::uint64_t                                                     formatted = 0;
+
+  /**
+   * @brief 指定した結果で終わったパースの回数
+   */
+  [[nodiscard]]
+  auto count(parse_status const status) const noexcept -> std::uint64_t {
+    auto total = std::uint64_t{0};
+    for (auto const n : parsed[static_cast<std::size_t>(status)]) {
+      total += n;
+    }
+    return total;
+  }
+
+  /**
+   * @brief 指定した処理を使ったパースの回数
+   */
+  [[nodiscard]]
+  auto count(parse_kernel const kernel) const noexcept -> std::uint64_t {
+    auto total = std::uint64_t{0};
+    for (auto const& row : parsed) {
+      total += row[static_cast<std::size_t>(kernel)];
+    }
+    return total;
+  }
+
+  /**
+   * @brief 失敗したパースの回数
+   */
+  [[nodiscard]]
+  auto failures() const noexcept -> std::uint64_t {
+    return count(parse_status::too_short) + count(parse_status::invalid_delimiter) + count(parse_status::invalid_hex);
+  }
+
+  /**
+   * @brief 2つの集計の差（ある区間の回数を求めるために使う）
+   */
+  [[nodiscard]]
+  friend auto operator-(mac_stats_snapshot const& lhs, mac_stats_snapshot const& rhs) noexcept -> mac_stats_snapshot {
+    auto diff = mac_stats_snapshot{};
+    for (auto s = std::size_t{0}; s < STATUS_COUNT; ++s) {
+      for (auto k = std::size_t{0}; k < KERNEL_COUNT; ++k) {
+        diff.parsed[s][k] = lhs.parsed[s][k] - rhs.parsed[s][k];
+      }
+    }
+    diff.formatted = lhs.formatted - rhs.formatted;
+    return diff;
+  }
+};
+
+/**
+ * @brief スレッドごとのカウンタで回数を数える統計ポリシー
+ *
+ * `Options::stats` に指定すると、`parse_mac_address` / `format_mac_address_to_buffer` の呼び出しごとに
+ * 結果と使われた処理を数えます
+ *
+ * ```cpp
+ * struct counted_options : macad_parser::parse_mac_options {
+ *   using stats = macad_parser::thread_local_mac_stats<>;
+ * };
+ * ```
+ *
+ * - 各スレッドは自分専用のスロット（キャッシュライン単位で分離）にだけ書き込み、RMW命令もロックも使いません
+ * - `snapshot()` は全スロットを読み出して合計します。他スレッドの書き込みとは並行に呼べます
+ * - スロットは最初の呼び出し時に確保してロックフリーのリストに繋ぎ、スレッド終了後は次のスレッドが再利用します
+ *   （回数はスロットに残るため、終了したスレッドの分も合計に含まれます。スロットは解放しません）
+ * - スロットの確保に失敗した場合は `std::terminate` します
+ *
+ * @tparam Tag 別々に数えたい場合に区別するための型
+ */
+template <typename Tag = void>
+class thread_local_mac_stats {
+  static constexpr std::size_t PARSE_COUNTERS = mac_stats_snapshot::STATUS_COUNT * mac_stats_snapshot::KERNEL_COUNT;
+
+  struct alignas(64) slot {
+    std::array<std::atomic<std::uint64_t>, PARSE_COUNTERS> parsed{};
+    std::atomic<std::uint64_t>                             formatted{0};
+    std::atomic<bool>                                      in_use{true};
+    slot*                                                  next = nullptr;
+  };
+
+  // スレッド終了時にスロットを返却する
+  struct owner {
+    slot* const s = acquire();
+
+    ~owner() {
+      s->in_use.store(false, std::memory_order_release);
+    }
+  };
+
+public:
+  static void on_parse(parse_status const status, parse_kernel const kernel) noexcept {
+    increment(local().parsed[static_cast<std::size_t>(status) * mac_stats_snapshot::KERNEL_COUNT + static_cast<std::size_t>(kernel)]);
+  }
+
+  static void on_format() noexcept {
+    increment(local().formatted);
+  }
+
+  /**
+   * @brief これまでの回数を全スレッド分合計する
+   */
+  [[nodiscard]]
+  static auto snapshot() noexcept -> mac_stats_snapshot {
+    auto total = mac_stats_snapshot{};
+    for (auto const* s = head_.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      for (auto i = std::size_t{0}; i < PARSE_COUNTERS; ++i) {
+        total.parsed[i / mac_stats_snapshot::KERNEL_COUNT][i % mac_stats_snapshot::KERNEL_COUNT] += s->parsed[i].load(std::memory_order_relaxed);
+      }
+      total.formatted += s->formatted.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+private:
+  // 書き込むのは持ち主のスレッドだけなので、fetch_add ではなく読み込みと書き込みで足す
+  static void increment(std::atomic<std::uint64_t>& counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  static auto local() noexcept -> slot& {
+    thread_local auto const o = owner{};
+    return *o.s;
+  }
+
+  // 空いているスロットを再利用し、なければ新しく確保してリストの先頭に繋ぐ
+  static auto acquire() -> slot* {
+    for (auto* s = head_.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      auto expected = false;
+      if (s->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return s;
+      }
+    }
+    auto* const s = new slot{};
+    s->next       = head_.load(std::memory_order_relaxed);
+    while (not head_.compare_exchange_weak(s->next, s, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return s;
+  }
+
+  static inline std::atomic<slot*> head_{nullptr};
+};
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_STATS_HPP */
@@ -0,0 +1,322 @@
+#ifndef MACAD_PARSER_STREAM_HPP
+#define MACAD_PARSER_STREAM_HPP
+
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+/**
+ * @brief 値を1つずつ遅延して生成するコルーチン（入力範囲として range-for で使う）
+ *
+ * `std::generator` を持たない標準ライブラリでも使えるよう、必要最小限の機能だけを自前で実装しています
+ *
+ * @tparam T 生成する値の型
+ */
+template <typename T>
+class generator {
+public:
+  struct promise_type {
+    T const*           current = nullptr;
+    std::exception_ptr exception;
+
+    auto get_return_object() noexcept -> generator {
+      return generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    auto initial_suspend() noexcept -> std::suspend_always {
+      return {};
+    }
+    auto final_suspend() noexcept -> std::suspend_always {
+      return {};
+    }
+    auto yield_value(T const& value) noexcept -> std::suspend_always {
+      current = std::addressof(value);
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept {
+      exception = std::current_exception();
+    }
+
+    // co_await は使わない
+    template <typename U>
+    auto await_transform(U&&) -> std::suspend_never = delete;
+  };
+
+  class iterator {
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type       = T;
+    using difference_type  = std::ptrdiff_t;
+
+    iterator() = default;
+
+    auto operator*() const noexcept -> T const& {
+      return *handle_.promise().current;
+    }
+    auto operator++() -> iterator& {
+      resume(handle_);
+      return *this;
+    }
+    void operator++(int) {
+      ++*this;
+    }
+    friend auto operator==(iterator const& it, std::default_sentinel_t) noexcept -> bool {
+      return it.handle_ == nullptr or it.handle_.done();
+    }
+
+  private:
+    friend class generator;
+
+    explicit iterator(std::coroutine_handle<promise_type> const handle) noexcept : handle_{handle} {}
+
+    std::coroutine_handle<promise_type> handle_ = nullptr;
+  };
+
+  generator(generator&& other) noexcept : handle_{std::exchange(other.handle_, nullptr)} {}
+  generator(generator const&)                    = delete;
+  auto operator=(generator const&) -> generator& = delete;
+  auto operator=(generator&& other) noexcept -> generator& {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  ~generator() {
+    destroy();
+  }
+
+  /**
+   * @brief 最初の値まで進めてイテレータを返す（1回だけ呼べる）
+   */
+  auto begin() -> iterator {
+    resume(handle_);
+    return iterator{handle_};
+  }
+
+  auto end() const noexcept -> std::default_sentinel_t {
+    return std::default_sentinel;
+  }
+
+private:
+  explicit generator(std::coroutine_handle<promise_type> const handle) noexcept : handle_{handle} {}
+
+  static void resume(std::coroutine_handle<promise_type> const handle) {
+    handle.resume();
+    if (handle.done() and handle.promise().exception) {
+      std::rethrow_exception(handle.promise().exception);
+    }
+  }
+
+  void destroy() noexcept {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief 順に届くセグメント（ソケットやリングバッファの断片）からMACアドレスを取り出す再開可能なスキャナ
+ *
+ * 各セグメントは `scan_mac_addresses` でその場で走査し、セグメント末尾で途切れたMACアドレスの候補（最大16byte）だけを内部に持ち越します
+ * 持ち越した候補は次のセグメントの先頭16byteとつないだ小さなバッファで確定するため、呼び出し側でセグメントを連結する必要はありません
+ * 結果は、すべてのセグメントを連結したテキストを `scan_mac_addresses` で走査した場合と同じです
+ * 持ち越しは17byte未満なので、ストリームの終端で確定していない候補はありません
+ *
+ * @tparam Options デリミタを指定するオプション（`scan_mac_addresses` に渡す）
+ */
+template <typename Options = parse_mac_options>
+class mac_stream_scanner {
+public:
+  /**
+   * @brief 次のセグメントを走査する
+   *
+   * @param segment ストリームの続きのバイト列（呼び出しの間だけ有効であればよい）
+   * @param on_match 確定するたびに `on_match(std::size_t offset, std::uint64_t value)` の形で呼ばれる（offset はストリーム先頭からの位置）
+   * @return このセグメントで確定したMACアドレスの数
+   */
+  template <typename F>
+  auto feed(std::span<char const> const segment, F&& on_match) -> std::size_t {
+    auto count = std::size_t{0};
+    auto skip  = std::size_t{0};
+
+    if (carry_size_ > 0 or segment.size() < CARRY_CAPACITY) {
+      // 持ち越した候補とセグメントの先頭をつなぐ
+      auto       head      = std::array<char, CARRY_CAPACITY * 2>{};
+      auto const take      = (segment.size() < CARRY_CAPACITY) ? segment.size() : CARRY_CAPACITY;
+      auto const head_size = carry_size_ + take;
+      std::memcpy(head.data(), carry_.data(), carry_size_);
+      std::memcpy(head.data() + carry_size_, segment.data(), take);
+
+      // セグメントが短い場合は、17文字そろった候補だけを確定する
+      auto const complete = segment.size() >= CARRY_CAPACITY;
+      auto const limit    = complete ? carry_size_ : (head_size > CARRY_CAPACITY) ? head_size - CARRY_CAPACITY : 0;
+      auto const base     = consumed_ - carry_size_;
+      auto       end      = std::size_t{0};
+      scan_mac_addresses<Options>(std::string_view{head.data(), head_size}, [&](std::size_t const offset, std::uint64_t const value) {
+        if (offset < limit) {
+          on_match(base + offset, value);
+          end = offset + MAC_ADDRESS_STRING_LENGTH;
+          ++count;
+        }
+      });
+
+      if (not complete) {
+        keep(std::span<char const>{head.data(), head_size}, (end > limit) ? end : limit);
+        consumed_ += segment.size();
+        return count;
+      }
+      // 確定したMACアドレスがセグメントに食い込んだ分は走査しない
+      skip = (end > carry_size_) ? end - carry_size_ : 0;
+    }
+
+    // セグメントの末尾16byteから始まる候補は、次のセグメントが届くまで確定できない
+    auto const limit = segment.size() - CARRY_CAPACITY;
+    auto       end   = skip;
+    scan_mac_addresses<Options>(std::string_view{segment.data() + skip, segment.size() - skip}, [&](std::size_t const offset, std::uint64_t const value) {
+      if (skip + offset < limit) {
+        on_match(consumed_ + skip + offset, value);
+        end = skip + offset + MAC_ADDRESS_STRING_LENGTH;
+        ++count;
+      }
+    });
+    keep(segment, (end > limit) ? end : limit);
+    consumed_ += segment.size();
+    return count;
+  }
+
+  /**
+   * @brief 複数のセグメント（scatter-gather の入力）を順に走査する
+   *
+   * @param segments ストリームの続きのバイト列の並び
+   * @param on_match 確定するたびに `on_match(std::size_t offset, std::uint64_t value)` の形で呼ばれる
+   * @return 確定したMACアドレスの数
+   */
+  template <typename F>
+  auto feed(std::span<std::span<char const> const> const segments, F&& on_match) -> std::size_t {
+    auto count = std::size_t{0};
+    for (auto const segment : segments) {
+      count += feed(segment, on_match);
+    }
+    return count;
+  }
+
+  /**
+   * @brief 持ち越している未確定のバイト数（最大16）
+   */
+  [[nodiscard]]
+  auto pending() const noexcept -> std::size_t {
+    return carry_size_;
+  }
+
+  /**
+   * @brief これまでに受け取ったバイト数
+   */
+  [[nodiscard]]
+  auto consumed() const noexcept -> std::size_t {
+    return consumed_;
+  }
+
+  /**
+   * @brief 新しいストリームの走査を始める
+   */
+  void reset() noexcept {
+    carry_size_ = 0;
+    consumed_   = 0;
+  }
+
+private:
+  // MACアドレスの先頭候補は、17文字目が届くまでの最大16byteだけ持ち越せばよい
+  static constexpr std::size_t CARRY_CAPACITY = MAC_ADDRESS_STRING_LENGTH - 1;
+
+  void keep(std::span<char const> const bytes, std::size_t const from) noexcept {
+    carry_size_ = bytes.size() - from;
+    std::memmove(carry_.data(), bytes.data() + from, carry_size_);
+  }
+
+  std::array<char, CARRY_CAPACITY> carry_{};
+  std::size_t                      carry_size_ = 0;
+  std::size_t                      consumed_   = 0;
+};
+
+/**
+ * @brief バイト列のソースからMACアドレスを遅延して読み出す
+ *
+ * 内部で `chunk_size` バイトずつ読み込み、`mac_stream_scanner` でチャンク内のMACアドレスをまとめて取り出してから1つずつ返します
+ * チャンクの末尾で途切れたMACアドレスの候補（最大16byte）はスキャナが次のチャンクに持ち越すため、
+ * チャンク境界をまたぐMACアドレスも取りこぼしません
+ *
+ * @tparam Options デリミタを指定するオプション（`scan_mac_addresses` に渡す）
+ * @param read `read(std::span<char> buffer) -> std::size_t` の形で呼ばれ、読み込んだバイト数を返す（0で終端）
+ * @param chunk_size 1回に読み込むバイト数
+ * @return 見つかった順にMACアドレス（48bit整数）を生成するジェネレータ
+ */
+template <typename Options = parse_mac_options, typename Read>
+  requires std::invocable<Read&, std::span<char>>
+auto read_mac_addresses(Read read, std::size_t const chunk_size = std::size_t{1} << 20) -> generator<std::uint64_t> {
+  auto buffer  = std::string(chunk_size, '\0');
+  auto batch   = std::vector<std::uint64_t>{};
+  auto scanner = mac_stream_scanner<Options>{};
+  while (true) {
+    auto const n = read(std::span<char>{buffer.data(), chunk_size});
+    if (n == 0) {
+      co_return;
+    }
+    batch.clear();
+    scanner.feed(std::span<char const>{buffer.data(), n}, [&](std::size_t, std::uint64_t const value) { batch.push_back(value); });
+    for (auto const value : batch) {
+      co_yield value;
+    }
+  }
+}
+
+/**
+ * @brief 入力ストリームからMACアドレスを遅延して読み出す
+ *
+ * @param in 入力ストリーム（ジェネレータを使い終わるまで生存している必要がある）
+ * @param chunk_size 1回に読み込むバイト数
+ */
+template <typename Options = parse_mac_options>
+auto read_mac_addresses(std::istream& in, std::size_t const chunk_size = std::size_t{1} << 20) -> generator<std::uint64_t> {
+  return read_mac_addresses<Options>(
+    [&in](std::span<char> const buffer) -> std::size_t {
+      in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      return static_cast<std::size_t>(in.gcount());
+    },
+    chunk_size);
+}
+
+/**
+ * @brief `FILE*` からMACアドレスを遅延して読み出す
+ *
+ * @param fp 入力ファイル（ジェネレータを使い終わるまで開いている必要がある）
+ * @param chunk_size 1回に読み込むバイト数
+ */
+template <typename Options = parse_mac_options>
+auto read_mac_addresses(std::FILE* const fp, std::size_t const chunk_size = std::size_t{1} << 20) -> generator<std::uint64_t> {
+  return read_mac_addresses<Options>([fp](std::span<char> const buffer) { return std::fread(buffer.data(), 1, buffer.size(), fp); }, chunk_size);
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_STREAM_HPP */
@@ -0,0 +1,152 @@
+#ifndef MACAD_PARSER_SWAR_HPP
+#define MACAD_PARSER_SWAR_HPP
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "macad-parser.hpp"
+
+/**
+ * @brief SIMD命令を使わず、64bit整数演算で8文字ずつ処理する（SWAR: SIMD within a register）カーネル
+ *
+ * 入力からは17byteしか読まないため、32byte読めない `std::string_view` でもコピーせずにパースできます
+ * 短い入力が多い場合や、SIMDのレイテンシが大きいCPUでは `macad_parser::parse_mac_address` より速いことがあります
+ * どちらが速いかは `macad-parser-autotune.hpp` で実測して選べます
+ */
+namespace macad_parser::swar {
+
+static_assert(std::endian::native == std::endian::little, "SWAR kernels assume a little-endian target");
+
+namespace detail {
+  inline constexpr std::uint64_t ONES = 0x0101010101010101ull;
+
+  // 8文字の16進数文字をそれぞれ数値(0-15)に変換する（'0'-'9' は下位4bit、英字は下位4bit + 9）
+  // デリミタなど16進数以外の文字も4bitに収め、隣のbyteに桁上がりしないようにする
+  [[nodiscard]]
+  constexpr auto hex_nibbles(std::uint64_t const x) noexcept -> std::uint64_t {
+    return ((x & (ONES * 0x0F)) + ((x >> 6) & ONES) * 9) & (ONES * 0x0F);
+  }
+
+  // n_k を byte k に持つ値から、byte k = (n_k << 4) | n_{k+1} を作る
+  [[nodiscard]]
+  constexpr auto pair_nibbles(std::uint64_t const n) noexcept -> std::uint64_t {
+    return (n << 4) | (n >> 8);
+  }
+
+  [[nodiscard]]
+  constexpr auto byte_at(std::uint64_t const x, int const k) noexcept -> std::uint64_t {
+    return (x >> (8 * k)) & 0xFF;
+  }
+
+  // 各byteが [Lo, Hi] の範囲にあれば、そのbyteの最上位bitを立てる（各byteが0x80未満であること）
+  template <unsigned char Lo, unsigned char Hi>
+  [[nodiscard]]
+  constexpr auto in_range(std::uint64_t const x) noexcept -> std::uint64_t {
+    return (x + ONES * (0x80 - Lo)) & ~(x + ONES * (0x7F - Hi)) & (ONES * 0x80);
+  }
+
+  // 各byteが16進数文字なら、そのbyteの最上位bitを立てる
+  [[nodiscard]]
+  constexpr auto hex_mask(std::uint64_t const x) noexcept -> std::uint64_t {
+    auto const ascii = ~x & (ONES * 0x80);
+    auto const low7  = x & (ONES * 0x7F);
+    auto const lower = low7 | (ONES * 0x20);
+    return ascii & (in_range<'0', '9'>(low7) | in_range<'a', 'f'>(lower));
+  }
+
+  // 16進数文字の位置（先頭8文字では 0,1,3,4,6,7、次の8文字では 9,10,12,13,15）
+  inline constexpr std::uint64_t HEX_POSITIONS_LO = 0x8080008080008080ull;
+  inline constexpr std::uint64_t HEX_POSITIONS_HI = 0x8000808000808000ull;
+
+  // 24bitの値を6文字の16進数文字（上位桁から順にbyte 0..5）に展開する
+  template <bool Upper>
+  [[nodiscard]]
+  constexpr auto hex_chars24(std::uint64_t x) noexcept -> std::uint64_t {
+    x                = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x                = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x                = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    auto const alpha = ((x + ONES * 0x06) >> 4) & ONES;
+    x += ONES * '0' + alpha * (Upper ? 'A' - '9' - 1 : 'a' - '9' - 1);
+    return std::byteswap(x) >> 16;
+  }
+}  // namespace detail
+
+/**
+ * @brief MACアドレスを示す文字列をパースして48bit整数に変換する（SWAR版）
+ *
+ * `macad_parser::parse_mac_address` と同じ結果を返します。`Options::stats` には `parse_kernel::direct` として報告します
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param mac パース対象のMACアドレス文字列 (例: "AA:BB:CC:DD:EE:FF")
+ * @return std::optional<std::uint64_t>
+ */
+template <typename Options = parse_mac_options>
+[[nodiscard]]
+auto parse_mac_address(std::string_view const mac) noexcept -> std::optional<std::uint64_t> {
+  if (mac.size() < MAC_ADDRESS_STRING_LENGTH) {
+    macad_parser::detail::record_parse<Options>(parse_status::too_short, parse_kernel::none);
+    return std::nullopt;
+  }
+  auto a = std::uint64_t{};
+  auto b = std::uint64_t{};
+  std::memcpy(&a, mac.data(), 8);
+  std::memcpy(&b, mac.data() + 8, 8);
+  auto const last = static_cast<unsigned char>(mac[16]);
+
+  if constexpr (macad_parser::detail::validate_delimiters_v<Options>) {
+    constexpr auto d = macad_parser::detail::delimiter_v<Options>;
+    if (mac[2] != d or mac[5] != d or mac[8] != d or mac[11] != d or mac[14] != d) {
+      macad_parser::detail::record_parse<Options>(parse_status::invalid_delimiter, parse_kernel::direct);
+      return std::nullopt;
+    }
+  }
+  if constexpr (macad_parser::detail::validate_hex_v<Options>) {
+    auto const valid_lo = (detail::hex_mask(a) & detail::HEX_POSITIONS_LO) == detail::HEX_POSITIONS_LO;
+    auto const valid_hi = (detail::hex_mask(b) & detail::HEX_POSITIONS_HI) == detail::HEX_POSITIONS_HI;
+    if (not valid_lo or not valid_hi or detail::hex_mask(last) != 0x80) {
+      macad_parser::detail::record_parse<Options>(parse_status::invalid_hex, parse_kernel::direct);
+      return std::nullopt;
+    }
+  }
+
+  auto const na = detail::hex_nibbles(a);
+  auto const nb = detail::hex_nibbles(b);
+  auto const ta = detail::pair_nibbles(na);
+  auto const tb = detail::pair_nibbles(nb);
+  auto const m5 = (detail::byte_at(nb, 7) << 4) | detail::hex_nibbles(last);
+  macad_parser::detail::record_parse<Options>(parse_status::success, parse_kernel::direct);
+  return (detail::byte_at(ta, 0) << 40) | (detail::byte_at(ta, 3) << 32) | (detail::byte_at(ta, 6) << 24) | (detail::byte_at(tb, 1) << 16) | (detail::byte_at(tb, 4) << 8) | m5;
+}
+
+/**
+ * @brief 48bit整数をMACアドレス文字列に変換し、指定されたバッファに書き込む（SWAR版）
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param mac 48bit整数値（0x0000000000000000〜0x0000FFFFFFFFFFFF）
+ * @param buffer 出力先のバッファ（17バイトが必要）
+ * @return 書き込まれた文字数（常に17）
+ */
+template <typename Options = parse_mac_options>
+auto format_mac_address_to_buffer(std::uint64_t const mac, std::span<char, MAC_ADDRESS_STRING_LENGTH> const buffer) noexcept -> std::size_t {
+  constexpr auto upper = macad_parser::detail::uppercase_v<Options>;
+  auto const     hi    = detail::hex_chars24<upper>((mac >> 24) & 0xFFFFFF);
+  auto const     lo    = detail::hex_chars24<upper>(mac & 0xFFFFFF);
+  auto* const    p     = buffer.data();
+  for (auto i = 0; i < 3; ++i) {
+    p[i * 3 + 0]  = static_cast<char>(detail::byte_at(hi, i * 2));
+    p[i * 3 + 1]  = static_cast<char>(detail::byte_at(hi, i * 2 + 1));
+    p[i * 3 + 9]  = static_cast<char>(detail::byte_at(lo, i * 2));
+    p[i * 3 + 10] = static_cast<char>(detail::byte_at(lo, i * 2 + 1));
+  }
+  p[2] = p[5] = p[8] = p[11] = p[14] = macad_parser::detail::delimiter_v<Options>;
+  macad_parser::detail::record_format<Options>();
+  return MAC_ADDRESS_STRING_LENGTH;
+}
+
+}  // namespace macad_parser::swar
+
+#endif /* MACAD_PARSER_SWAR_HPP */
@@ -0,0 +1,288 @@
+#ifndef MACAD_PARSER_TABLE_HPP
+#define MACAD_PARSER_TABLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+namespace detail {
+  /**
+   * @brief 48bitのMACアドレスを64bitに拡散するハッシュ (multiply-xorshift)
+   */
+  [[nodiscard]]
+  constexpr auto mix_mac_address(std::uint64_t x) noexcept -> std::uint64_t {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+  }
+}  // namespace detail
+
+/**
+ * @brief 複数のMACアドレス文字列をまとめてパースしてから、`concurrent_mac_table` で使うハッシュ値を別のループで求める
+ *
+ * パースは `parse_mac_addresses` のバッチ処理に任せ、その結果からスカラーの乗算で `detail::mix_mac_address` を求めます
+ * AVX2には64bit同士の乗算がないため、ハッシュは4レーンのベクトル演算（32bit乗算3回で組み立てる）よりスカラーの方が速く、
+ * パースと同じループに混ぜるよりも、パースを終えてから別のループで求める方が速くなります
+ * `hashes[i]` は `out[i]` に値がある場合だけ意味を持ちます（`concurrent_mac_table::upsert_hashed` などに渡す）
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param macs パース対象のMACアドレス文字列の並び
+ * @param out パース結果の書き込み先
+ * @param hashes ハッシュ値の書き込み先
+ * @return パースに成功した要素数
+ */
+template <typename Options = parse_mac_options>
+auto parse_and_hash_mac_addresses(std::span<std::string_view const> const macs, std::span<std::optional<std::uint64_t>> const out, std::span<std::uint64_t> const hashes) noexcept
+  -> std::size_t {
+  auto const n       = std::min({macs.size(), out.size(), hashes.size()});
+  auto const success = parse_mac_addresses<Options>(macs.first(n), out.first(n));
+  for (auto i = std::size_t{0}; i < n; ++i) {
+    hashes[i] = detail::mix_mac_address(out[i].value_or(0));
+  }
+  return success;
+}
+
+/**
+ * @brief 複数スレッドから同時に更新できるMACアドレスをキーとする固定容量のハッシュテーブル
+ *
+ * オープンアドレス法（線形探索）で、各スロットのキーは64bitのatomic1語で管理します
+ * 下位48bitにMACアドレス、上位2bitにスロットの状態（空き / 確保中 / 公開済み）を持ちます
+ *
+ * - `find` はロックを取らず、高々容量分のスロットを見るだけで終わる（wait-free）
+ * - `upsert` は空きスロットをCASで確保してから値を書き込み、公開する（lock-free）
+ * - 要素の削除と容量の拡張は行いません（容量は構築時に2のべき乗へ切り上げ）
+ *
+ * @tparam Value 値の型（8バイト以下のtrivially copyableな型。例: ポート番号と時刻をパックした整数）
+ */
+template <typename Value = std::uint64_t>
+  requires(std::is_trivially_copyable_v<Value> and std::is_default_constructible_v<Value> and sizeof(Value) <= sizeof(std::uint64_t))
+class concurrent_mac_table {
+public:
+  using value_type = Value;
+
+  /**
+   * @brief 指定した数以上のスロットを持つテーブルを構築する
+   *
+   * @param capacity 最低限必要なスロット数（2のべき乗へ切り上げる）
+   */
+  explicit concurrent_mac_table(std::size_t const capacity)
+    : mask_{std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1}, slots_{std::make_unique<slot[]>(mask_ + 1)} {}
+
+  /**
+   * @brief MACアドレスに対応する値を挿入または上書きする
+   *
+   * @param mac 48bitのMACアドレス（上位16bitは無視される）
+   * @param value 書き込む値
+   * @return 書き込めた場合は true、テーブルが満杯で挿入できなかった場合は false
+   */
+  auto upsert(std::uint64_t const mac, Value const value) noexcept -> bool {
+    return upsert_hashed(mac, detail::mix_mac_address(mac & MAC_MASK), value);
+  }
+
+  /**
+   * @brief 計算済みのハッシュ値を使って挿入または上書きする
+   *
+   * @param mac 48bitのMACアドレス（上位16bitは無視される）
+   * @param hash `mac` のハッシュ値（同じMACアドレスには常に同じ値を渡すこと）
+   * @param value 書き込む値
+   * @return 書き込めた場合は true、テーブルが満杯で挿入できなかった場合は false
+   */
+  auto upsert_hashed(std::uint64_t const mac, std::uint64_t const hash, Value const value) noexcept -> bool {
+    auto const key  = mac & MAC_MASK;
+    auto const bits = to_bits(value);
+    auto       idx  = static_cast<std::size_t>(hash) & mask_;
+    for (auto probe = std::size_t{0}; probe <= mask_; ++probe, idx = (idx + 1) & mask_) {
+      auto& s    = slots_[idx];
+      auto  word = s.key.load(std::memory_order_acquire);
+      if (word == STATE_EMPTY) {
+        // 空きスロットを確保中の状態で取得してから値を書き、公開する
+        if (s.key.compare_exchange_strong(word, STATE_BUSY | key, std::memory_order_acq_rel, std::memory_order_acquire)) {
+          s.value.store(bits, std::memory_order_relaxed);
+          s.key.store(STATE_READY | key, std::memory_order_release);
+          return true;
+        }
+        // 他のスレッドが先に確保した。そのキーが自分と同じかもしれないので同じスロットを調べ直す
+      }
+      if ((word & MAC_MASK) == key) {
+        // 確保中であっても値は書いてよい（確保したスレッドとの書き込み順は並行な操作の順序として扱う）
+        s.value.store(bits, std::memory_order_release);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief MACアドレス文字列をパースして、対応する値をまとめて挿入または上書きする
+   *
+   * `INGEST_BATCH` 件ずつ `parse_and_hash_mac_addresses` でパースとハッシュを済ませ、
+   * 挿入先のスロットをプリフェッチしてから1つ前のバッチを挿入します
+   * （あるバッチのスロットを読み込んでいる間に、前のバッチの挿入が進む）
+   * パースに失敗した文字列とテーブルが満杯で挿入できなかった要素は飛ばします
+   *
+   * @tparam Options パースの仕方を指定するオプション
+   * @param macs MACアドレス文字列の並び
+   * @param values `macs` の同じ位置に対応する値（`macs` より短い場合は短い方に合わせる）
+   * @return 書き込めた要素数
+   */
+  template <typename Options = parse_mac_options>
+  auto upsert_mac_addresses(std::span<std::string_view const> const macs, std::span<Value const> const values) noexcept -> std::size_t {
+    auto const n      = (macs.size() < values.size()) ? macs.size() : values.size();
+    auto       parsed = std::array<std::array<std::optional<std::uint64_t>, INGEST_BATCH>, 2>{};
+    auto       hashes = std::array<std::array<std::uint64_t, INGEST_BATCH>, 2>{};
+
+    // first から最大 INGEST_BATCH 件をパースし、挿入先をプリフェッチする
+    auto const stage = [&](std::size_t const first, std::size_t const buf) -> std::size_t {
+      auto const count = (n - first < INGEST_BATCH) ? n - first : INGEST_BATCH;
+      parse_and_hash_mac_addresses<Options>(macs.subspan(first, count), std::span{parsed[buf]}.first(count), std::span{hashes[buf]}.first(count));
+      for (auto i = std::size_t{0}; i < count; ++i) {
+        if (parsed[buf][i]) {
+          prefetch_hashed(hashes[buf][i]);
+        }
+      }
+      return count;
+    };
+
+    auto written = std::size_t{0};
+    auto buf     = std::size_t{0};
+    auto count   = (n > 0) ? stage(0, buf) : 0;
+    for (auto first = std::size_t{0}; first < n; buf ^= 1) {
+      auto const next       = first + count;
+      auto const next_count = (next < n) ? stage(next, buf ^ 1) : 0;
+      for (auto i = std::size_t{0}; i < count; ++i) {
+        if (auto const mac = parsed[buf][i]) {
+          written += upsert_hashed(*mac, hashes[buf][i], values[first + i]) ? 1 : 0;
+        }
+      }
+      first = next;
+      count = next_count;
+    }
+    return written;
+  }
+
+  /**
+   * @brief MACアドレスに対応する値を取得する
+   *
+   * @param mac 48bitのMACアドレス（上位16bitは無視される）
+   * @return 値。登録されていない場合（または挿入途中の場合）は `std::nullopt`
+   */
+  [[nodiscard]]
+  auto find(std::uint64_t const mac) const noexcept -> std::optional<Value> {
+    return find_hashed(mac, detail::mix_mac_address(mac & MAC_MASK));
+  }
+
+  /**
+   * @brief 計算済みのハッシュ値を使って値を取得する
+   */
+  [[nodiscard]]
+  auto find_hashed(std::uint64_t const mac, std::uint64_t const hash) const noexcept -> std::optional<Value> {
+    auto const key = mac & MAC_MASK;
+    auto       idx = static_cast<std::size_t>(hash) & mask_;
+    for (auto probe = std::size_t{0}; probe <= mask_; ++probe, idx = (idx + 1) & mask_) {
+      auto const& s    = slots_[idx];
+      auto const  word = s.key.load(std::memory_order_acquire);
+      if (word == STATE_EMPTY) {
+        return std::nullopt;
+      }
+      if ((word & MAC_MASK) == key) {
+        if ((word & STATE_READY) == 0) {
+          return std::nullopt;
+        }
+        return from_bits(s.value.load(std::memory_order_acquire));
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief 計算済みのハッシュ値が指すスロットを、検索や挿入より前にキャッシュへ読み込み始める
+   *
+   * 続けて処理するキーが先に分かっている場合に、数件先のキーについて呼んでおくとキャッシュミスの待ちを重ねられます
+   */
+  void prefetch_hashed(std::uint64_t const hash) const noexcept {
+    simde_mm_prefetch(reinterpret_cast<char const*>(&slots_[static_cast<std::size_t>(hash) & mask_]), SIMDE_MM_HINT_T0);
+  }
+
+  /**
+   * @brief 公開済みの全要素を列挙する（他スレッドの更新と並行に呼べるが、スナップショットではない）
+   *
+   * @param f `f(std::uint64_t mac, Value value)` の形で呼ばれる
+   */
+  template <typename F>
+  void for_each(F&& f) const {
+    for (auto i = std::size_t{0}; i <= mask_; ++i) {
+      auto const word = slots_[i].key.load(std::memory_order_acquire);
+      if ((word & STATE_READY) != 0) {
+        f(word & MAC_MASK, from_bits(slots_[i].value.load(std::memory_order_acquire)));
+      }
+    }
+  }
+
+  /**
+   * @brief 公開済みの要素数を数える（全スロットを走査する）
+   */
+  [[nodiscard]]
+  auto size() const noexcept -> std::size_t {
+    auto n = std::size_t{0};
+    for_each([&](std::uint64_t, Value) { ++n; });
+    return n;
+  }
+
+  [[nodiscard]]
+  auto capacity() const noexcept -> std::size_t {
+    return mask_ + 1;
+  }
+
+  /**
+   * @brief `upsert_mac_addresses` が1回にパースしてプリフェッチする件数
+   */
+  static constexpr std::size_t INGEST_BATCH = 16;
+
+private:
+  static constexpr std::uint64_t MAC_MASK    = 0xFFFFFFFFFFFFull;
+  static constexpr std::uint64_t STATE_EMPTY = 0;
+  static constexpr std::uint64_t STATE_BUSY  = std::uint64_t{1} << 62;
+  static constexpr std::uint64_t STATE_READY = std::uint64_t{1} << 63;
+
+  // キーと値を同じ16byte内に置き、1回の探索で触るキャッシュラインを1本に抑える
+  struct alignas(16) slot {
+    std::atomic<std::uint64_t> key{STATE_EMPTY};
+    std::atomic<std::uint64_t> value{0};
+  };
+
+  [[nodiscard]]
+  static auto to_bits(Value const value) noexcept -> std::uint64_t {
+    auto bits = std::uint64_t{0};
+    std::memcpy(&bits, &value, sizeof(Value));
+    return bits;
+  }
+
+  [[nodiscard]]
+  static auto from_bits(std::uint64_t const bits) noexcept -> Value {
+    auto value = Value{};
+    std::memcpy(&value, &bits, sizeof(Value));
+    return value;
+  }
+
+  std::size_t             mask_;
+  std::unique_ptr<slot[]> slots_;
+};
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_TABLE_HPP */
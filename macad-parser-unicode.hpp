@@ -0,0 +1,174 @@
+#ifndef MACAD_PARSER_UNICODE_HPP
+#define MACAD_PARSER_UNICODE_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "macad-parser.hpp"
+
+/**
+ * @brief UTF-16 / UTF-32 の文字列を直接パース・フォーマットするオーバーロード
+ *
+ * Windowsのエクスポートや Java/.NET との連携で得られる `std::u16string_view` などを、呼び出し側で1文字ずつ狭めずに扱えます
+ * パースでは先頭16文字をベクトルのまま飽和パック（packus）で1byteに狭めてから、通常の `char` 版のカーネルに渡します
+ * 0x80以上のコード単位は0x80以上（または0）に飽和するため、ASCIIの16進数文字やデリミタと取り違えることはありません
+ */
+namespace macad_parser {
+
+namespace detail {
+  // 1byteに狭められないコード単位の代わりに使う値（16進数文字にもデリミタにもならない）
+  template <typename CharT>
+  [[nodiscard]]
+  constexpr auto narrow_code_unit(CharT const c) noexcept -> char {
+    return static_cast<char>(c < 0x80 ? c : 0xFF);
+  }
+
+  // 17文字を1byteずつに狭めて、32byteのゼロ埋めバッファに書き込む（入力から17文字しか読まない）
+  inline void narrow_mac_address(char16_t const* const src, std::array<char, 32>& dst) noexcept {
+    auto const lo = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(src));
+    auto const hi = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(src + 8));
+    simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(dst.data()), simde_mm_packus_epi16(lo, hi));
+    dst[16] = narrow_code_unit(src[16]);
+  }
+
+  inline void narrow_mac_address(char32_t const* const src, std::array<char, 32>& dst) noexcept {
+    auto const a = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(src));
+    auto const b = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(src + 4));
+    auto const c = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(src + 8));
+    auto const d = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(src + 12));
+    // 32bit -> 16bit は符号付きとして飽和するため、0x80000000以上のコード単位は0になる（ASCIIの16進数文字にはならない）
+    auto const ab = simde_mm_packus_epi32(a, b);
+    auto const cd = simde_mm_packus_epi32(c, d);
+    simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(dst.data()), simde_mm_packus_epi16(ab, cd));
+    dst[16] = narrow_code_unit(src[16]);
+  }
+
+  template <typename CharT, typename Options>
+  [[nodiscard]]
+  auto parse_wide_mac_address(std::basic_string_view<CharT> const mac) noexcept -> std::optional<std::uint64_t> {
+    if (mac.size() < MAC_ADDRESS_STRING_LENGTH) {
+      record_parse<Options>(parse_status::too_short, parse_kernel::none);
+      return std::nullopt;
+    }
+    auto buf = std::array<char, 32>{};
+    narrow_mac_address(mac.data(), buf);
+    // 統計を取らない場合は `char` 版の直接ロードと同じ実体を使う
+    constexpr auto kernel = HasStats<Options> ? parse_kernel::copied : parse_kernel::direct;
+    return parse_mac_address_unsafe<Options, kernel>(std::string_view{buf.data(), MAC_ADDRESS_STRING_LENGTH});
+  }
+
+  // `char` 版で書いた17文字をゼロ拡張して書き込む
+  template <typename Options>
+  void format_wide_mac_address(std::uint64_t const mac, std::span<char16_t, MAC_ADDRESS_STRING_LENGTH> const buffer) noexcept {
+    auto narrow = std::array<char, 32>{};
+    format_mac_address_to_buffer<Options>(mac, std::span{narrow}.first<MAC_ADDRESS_STRING_LENGTH>());
+    auto const chars = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(narrow.data()));
+    simde_mm256_storeu_si256(reinterpret_cast<simde__m256i*>(buffer.data()), simde_mm256_cvtepu8_epi16(chars));
+    buffer[16] = static_cast<char16_t>(narrow[16]);
+  }
+
+  template <typename Options>
+  void format_wide_mac_address(std::uint64_t const mac, std::span<char32_t, MAC_ADDRESS_STRING_LENGTH> const buffer) noexcept {
+    auto narrow = std::array<char, 32>{};
+    format_mac_address_to_buffer<Options>(mac, std::span{narrow}.first<MAC_ADDRESS_STRING_LENGTH>());
+    auto const chars = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(narrow.data()));
+    simde_mm256_storeu_si256(reinterpret_cast<simde__m256i*>(buffer.data()), simde_mm256_cvtepu8_epi32(chars));
+    simde_mm256_storeu_si256(reinterpret_cast<simde__m256i*>(buffer.data() + 8), simde_mm256_cvtepu8_epi32(simde_mm_srli_si128(chars, 8)));
+    buffer[16] = static_cast<char32_t>(narrow[16]);
+  }
+}  // namespace detail
+
+/**
+ * @brief UTF-16のMACアドレス文字列をパースして48bit整数に変換する
+ *
+ * 結果は同じ文字列を `char` で与えた場合と同じです。ASCII以外のコード単位は、検証するオプションでは不正な文字として扱います
+ * 入力からは17文字しか読まないため、コピーせずに渡せます
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param mac パース対象のMACアドレス文字列 (例: u"AA:BB:CC:DD:EE:FF")
+ * @return std::optional<std::uint64_t>
+ */
+template <typename Options = parse_mac_options>
+[[nodiscard]]
+auto parse_mac_address(std::u16string_view const mac) noexcept -> std::optional<std::uint64_t> {
+  return detail::parse_wide_mac_address<char16_t, Options>(mac);
+}
+
+/**
+ * @brief UTF-32のMACアドレス文字列をパースして48bit整数に変換する
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param mac パース対象のMACアドレス文字列 (例: U"AA:BB:CC:DD:EE:FF")
+ * @return std::optional<std::uint64_t>
+ */
+template <typename Options = parse_mac_options>
+[[nodiscard]]
+auto parse_mac_address(std::u32string_view const mac) noexcept -> std::optional<std::uint64_t> {
+  return detail::parse_wide_mac_address<char32_t, Options>(mac);
+}
+
+/**
+ * @brief 48bit整数をUTF-16のMACアドレス文字列に変換し、指定されたバッファに書き込む
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param mac 48bit整数値（0x0000000000000000〜0x0000FFFFFFFFFFFF）
+ * @param buffer 出力先のバッファ（17文字が必要）
+ * @return 書き込まれた文字数（常に17）
+ */
+template <typename Options = parse_mac_options>
+auto format_mac_address_to_buffer(std::uint64_t const mac, std::span<char16_t, MAC_ADDRESS_STRING_LENGTH> const buffer) noexcept -> std::size_t {
+  detail::format_wide_mac_address<Options>(mac, buffer);
+  return MAC_ADDRESS_STRING_LENGTH;
+}
+
+/**
+ * @brief 48bit整数をUTF-32のMACアドレス文字列に変換し、指定されたバッファに書き込む
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param mac 48bit整数値（0x0000000000000000〜0x0000FFFFFFFFFFFF）
+ * @param buffer 出力先のバッファ（17文字が必要）
+ * @return 書き込まれた文字数（常に17）
+ */
+template <typename Options = parse_mac_options>
+auto format_mac_address_to_buffer(std::uint64_t const mac, std::span<char32_t, MAC_ADDRESS_STRING_LENGTH> const buffer) noexcept -> std::size_t {
+  detail::format_wide_mac_address<Options>(mac, buffer);
+  return MAC_ADDRESS_STRING_LENGTH;
+}
+
+/**
+ * @brief 48bit整数をUTF-16のMACアドレス文字列に変換する
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param mac 48bit整数値（0x0000000000000000〜0x0000FFFFFFFFFFFF）
+ * @return std::u16string MACアドレス文字列 (例: u"AA:BB:CC:DD:EE:FF")
+ */
+template <typename Options = parse_mac_options>
+[[nodiscard]]
+auto format_mac_address_u16(std::uint64_t const mac) -> std::u16string {
+  auto result = std::u16string(MAC_ADDRESS_STRING_LENGTH, u'\0');
+  format_mac_address_to_buffer<Options>(mac, std::span<char16_t, MAC_ADDRESS_STRING_LENGTH>{result.data(), MAC_ADDRESS_STRING_LENGTH});
+  return result;
+}
+
+/**
+ * @brief 48bit整数をUTF-32のMACアドレス文字列に変換する
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param mac 48bit整数値（0x0000000000000000〜0x0000FFFFFFFFFFFF）
+ * @return std::u32string MACアドレス文字列 (例: U"AA:BB:CC:DD:EE:FF")
+ */
+template <typename Options = parse_mac_options>
+[[nodiscard]]
+auto format_mac_address_u32(std::uint64_t const mac) -> std::u32string {
+  auto result = std::u32string(MAC_ADDRESS_STRING_LENGTH, U'\0');
+  format_mac_address_to_buffer<Options>(mac, std::span<char32_t, MAC_ADDRESS_STRING_LENGTH>{result.data(), MAC_ADDRESS_STRING_LENGTH});
+  return result;
+}
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_UNICODE_HPP */
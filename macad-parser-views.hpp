@@ -0,0 +1,276 @@
+#ifndef MACAD_PARSER_VIEWS_HPP
+#define MACAD_PARSER_VIEWS_HPP
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "macad-parser.hpp"
+
+namespace macad_parser {
+
+namespace detail {
+  // ビューが1回のバッチ処理でまとめて変換する要素数
+  inline constexpr std::size_t VIEW_BLOCK_SIZE = 32;
+
+  // 入力範囲の要素を、連続したメモリにある場合はそのまま、そうでなければ `convert(*current, n)` で変換して一時配列に詰めてバッチ処理に渡す
+  template <typename T, std::ranges::input_range V, typename Convert, typename F>
+  auto for_next_block(V& base, std::ranges::iterator_t<V>& current, Convert&& convert, F&& f) -> std::size_t {
+    auto const end = std::ranges::end(base);
+    if constexpr (std::ranges::contiguous_range<V> and std::same_as<std::ranges::range_value_t<V>, T>) {
+      auto const rest = static_cast<std::size_t>(end - current);
+      auto const n    = rest < VIEW_BLOCK_SIZE ? rest : VIEW_BLOCK_SIZE;
+      f(std::span<T const>{std::to_address(current), n});
+      current += static_cast<std::ranges::range_difference_t<V>>(n);
+      return n;
+    } else {
+      auto block = std::array<T, VIEW_BLOCK_SIZE>{};
+      auto n     = std::size_t{0};
+      for (; n < VIEW_BLOCK_SIZE and current != end; ++n, ++current) {
+        block[n] = convert(*current, n);
+      }
+      f(std::span<T const>{block.data(), n});
+      return n;
+    }
+  }
+
+  /**
+   * @brief ブロック単位で変換した結果を1つずつ返すビューの共通部分
+   *
+   * 変換結果はビュー自身が持つバッファに置くため、入力範囲（input_range）として1回だけ走査できる
+   */
+  template <typename Derived, std::ranges::view V, typename Ref>
+  class block_view_base : public std::ranges::view_interface<Derived> {
+  public:
+    class iterator {
+    public:
+      using iterator_concept = std::input_iterator_tag;
+      using value_type       = std::remove_cvref_t<Ref>;
+      using difference_type  = std::ptrdiff_t;
+
+      iterator() = default;
+
+      auto operator*() const -> Ref {
+        return parent_->derived().element(parent_->pos_);
+      }
+      auto operator++() -> iterator& {
+        parent_->advance();
+        return *this;
+      }
+      void operator++(int) {
+        ++*this;
+      }
+      auto operator==(std::default_sentinel_t) const -> bool {
+        return parent_->pos_ == parent_->count_;
+      }
+
+    private:
+      friend class block_view_base;
+
+      explicit iterator(block_view_base* const parent) noexcept : parent_{parent} {}
+
+      block_view_base* parent_ = nullptr;
+    };
+
+    block_view_base() = default;
+    explicit block_view_base(V base) : base_{std::move(base)} {}
+
+    [[nodiscard]]
+    auto base() const& -> V
+      requires std::copy_constructible<V>
+    {
+      return base_;
+    }
+
+    /**
+     * @brief 最初のブロックを変換してイテレータを返す（1回だけ呼べる）
+     */
+    auto begin() -> iterator {
+      current_.emplace(std::ranges::begin(base_));
+      refill();
+      return iterator{this};
+    }
+
+    auto end() const noexcept -> std::default_sentinel_t {
+      return std::default_sentinel;
+    }
+
+    [[nodiscard]]
+    auto size()
+      requires std::ranges::sized_range<V>
+    {
+      return std::ranges::size(base_);
+    }
+
+  protected:
+    V base_;
+
+  private:
+    auto derived() -> Derived& {
+      return static_cast<Derived&>(*this);
+    }
+
+    void refill() {
+      pos_   = 0;
+      count_ = (*current_ == std::ranges::end(base_)) ? 0 : derived().convert_block(base_, *current_);
+    }
+
+    void advance() {
+      if (++pos_ == count_) {
+        refill();
+      }
+    }
+
+    // 入力専用の範囲のイテレータはデフォルト構築できないことがあるため、begin() までは空にしておく
+    std::optional<std::ranges::iterator_t<V>> current_;
+    std::size_t                               pos_   = 0;
+    std::size_t                               count_ = 0;
+  };
+}  // namespace detail
+
+/**
+ * @brief MACアドレス文字列の範囲を、ブロック単位でまとめてパースしながら1つずつ返すビュー
+ *
+ * `std::views::transform(parse_mac_address<>)` と同じ値（`std::optional<std::uint64_t>`）を返しますが、
+ * 内部では `VIEW_BLOCK_SIZE` 要素ずつ `parse_mac_addresses` に渡して変換します
+ * 入力が `std::string_view` の連続した範囲であればコピーせずにそのまま渡します
+ * 要素が左辺値参照で返る前方向範囲（`std::vector<std::string>` など）は要素を指す `std::string_view` を渡し、
+ * それ以外（一時オブジェクトを返す `std::views::transform` や `std::views::istream` など）は
+ * 各要素の先頭32byteまでをビュー内のバッファにコピーしてから渡します
+ *
+ * @tparam V 要素が `std::string_view` に変換できる入力ビュー
+ * @tparam Options パースの仕方を指定するオプション
+ */
+template <std::ranges::view V, typename Options = parse_mac_options>
+  requires std::ranges::input_range<V> and std::convertible_to<std::ranges::range_reference_t<V>, std::string_view>
+class parse_view : public detail::block_view_base<parse_view<V, Options>, V, std::optional<std::uint64_t>> {
+  using base_type = detail::block_view_base<parse_view<V, Options>, V, std::optional<std::uint64_t>>;
+
+public:
+  parse_view() = default;
+  explicit parse_view(V base) : base_type{std::move(base)} {}
+
+private:
+  friend base_type;
+
+  // 要素が指す文字列が次の要素へ進んだ後も残っている場合だけ、コピーせずに参照できる
+  static constexpr bool references_elements = std::ranges::forward_range<V> and std::is_lvalue_reference_v<std::ranges::range_reference_t<V>>;
+
+  // `parse_mac_address` が読むのは先頭32byteまでなので、それを越える部分はコピーしなくても結果は変わらない
+  static constexpr std::size_t COPY_LENGTH = 32;
+
+  auto convert_block(V& base, std::ranges::iterator_t<V>& current) -> std::size_t {
+    auto const convert = [&](std::ranges::range_reference_t<V>&& element, std::size_t const n) -> std::string_view {
+      auto const mac = std::string_view{element};
+      if constexpr (references_elements) {
+        static_cast<void>(n);
+        return mac;
+      } else {
+        auto const length = (mac.size() < COPY_LENGTH) ? mac.size() : COPY_LENGTH;
+        auto* const slot  = text_.data() + n * COPY_LENGTH;
+        std::memcpy(slot, mac.data(), length);
+        return std::string_view{slot, length};
+      }
+    };
+    return detail::for_next_block<std::string_view>(base, current, convert, [&](std::span<std::string_view const> const macs) {
+      static_cast<void>(parse_mac_addresses<Options>(macs, results_));
+    });
+  }
+
+  auto element(std::size_t const i) const -> std::optional<std::uint64_t> {
+    return results_[i];
+  }
+
+  std::array<std::optional<std::uint64_t>, detail::VIEW_BLOCK_SIZE> results_{};
+  std::array<char, references_elements ? 0 : detail::VIEW_BLOCK_SIZE * COPY_LENGTH> text_{};
+};
+
+/**
+ * @brief 48bit整数の範囲を、ブロック単位でまとめてMACアドレス文字列に変換しながら1つずつ返すビュー
+ *
+ * 内部では `VIEW_BLOCK_SIZE` 要素ずつ `format_mac_addresses_to_buffer` でビュー内のバッファに書き込み、
+ * その一部を指す `std::string_view` を返します
+ * 返した `std::string_view` は、次のブロックの変換が始まる（イテレータがブロックの末尾を越える）まで有効です
+ * 保持したい場合は `std::string` に変換してください
+ *
+ * @tparam V 要素が `std::uint64_t` に変換できる入力ビュー
+ * @tparam Options デリミタと大文字・小文字を指定するオプション
+ */
+template <std::ranges::view V, typename Options = parse_mac_options>
+  requires std::ranges::input_range<V> and std::convertible_to<std::ranges::range_reference_t<V>, std::uint64_t>
+class format_view : public detail::block_view_base<format_view<V, Options>, V, std::string_view> {
+  using base_type = detail::block_view_base<format_view<V, Options>, V, std::string_view>;
+
+public:
+  format_view() = default;
+  explicit format_view(V base) : base_type{std::move(base)} {}
+
+private:
+  friend base_type;
+
+  auto convert_block(V& base, std::ranges::iterator_t<V>& current) -> std::size_t {
+    auto const convert = [](std::ranges::range_reference_t<V>&& value, std::size_t) { return static_cast<std::uint64_t>(value); };
+    return detail::for_next_block<std::uint64_t>(base, current, convert, [&](std::span<std::uint64_t const> const macs) {
+      static_cast<void>(format_mac_addresses_to_buffer<Options>(macs, text_));
+    });
+  }
+
+  auto element(std::size_t const i) const -> std::string_view {
+    return std::string_view{text_.data() + i * MAC_ADDRESS_STRING_LENGTH, MAC_ADDRESS_STRING_LENGTH};
+  }
+
+  std::array<char, detail::VIEW_BLOCK_SIZE * MAC_ADDRESS_STRING_LENGTH> text_{};
+};
+
+namespace views {
+  namespace detail {
+    // `range | views::parse` と `views::parse(range)` の両方を可能にするアダプタ
+    template <template <typename, typename> typename View, typename Options>
+    struct adaptor {
+      template <std::ranges::viewable_range R>
+      auto operator()(R&& r) const {
+        return View<std::views::all_t<R>, Options>{std::views::all(std::forward<R>(r))};
+      }
+
+      template <std::ranges::viewable_range R>
+      friend auto operator|(R&& r, adaptor const& self) {
+        return self(std::forward<R>(r));
+      }
+    };
+  }  // namespace detail
+
+  /**
+   * @brief 任意の `Options` でパースするビューアダプタ（例: `lines | views::parse_with<parse_mac_options_strict>`）
+   */
+  template <typename Options>
+  inline constexpr detail::adaptor<parse_view, Options> parse_with{};
+
+  /**
+   * @brief 任意の `Options` でフォーマットするビューアダプタ（例: `values | views::format_with<opt_lowercase>`）
+   */
+  template <typename Options>
+  inline constexpr detail::adaptor<format_view, Options> format_with{};
+
+  /**
+   * @brief デフォルトの `Options` でパースするビューアダプタ
+   */
+  inline constexpr auto parse = parse_with<parse_mac_options>;
+
+  /**
+   * @brief デフォルトの `Options` でフォーマットするビューアダプタ
+   */
+  inline constexpr auto format = format_with<parse_mac_options>;
+}  // namespace views
+
+}  // namespace macad_parser
+
+#endif /* MACAD_PARSER_VIEWS_HPP */
@@ -3,13 +3,17 @@
 
 #include <array>
 #include <bit>
+#include <charconv>
 #include <concepts>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <memory_resource>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <type_traits>
 
 #include "simde/x86/avx2.h"
@@ -41,6 +45,25 @@ struct parse_mac_options_strict {
   static constexpr bool uppercase           = true;
 };
 
+/**
+ * @brief パースの結果（`Options::stats` に渡される）
+ */
+enum class parse_status : std::uint8_t {
+  success,
+  too_short,          ///< 17文字に満たない
+  invalid_delimiter,  ///< デリミタの検証に失敗した（validate_delimiters）
+  invalid_hex,        ///< 16進数文字の検証に失敗した（validate_hex）
+};
+
+/**
+ * @brief パースに使われた処理（`Options::stats` に渡される）
+ */
+enum class parse_kernel : std::uint8_t {
+  none,    ///< 長さの確認だけで終わった
+  direct,  ///< 入力から直接32byteをロードした
+  copied,  ///< 32byte読めない入力をゼロ埋めバッファにコピーしてからロードした
+};
+
 // Helper to provide default values for Options members
 namespace detail {
   template <typename T>
@@ -95,6 +118,27 @@ namespace detail {
     }
     return true;
   }();
+
+  // Options::stats に統計ポリシーの型があれば、パース/フォーマットのたびに呼び出す
+  //   static void on_parse(parse_status, parse_kernel) noexcept;
+  //   static void on_format() noexcept;
+  // ない場合は if constexpr で呼び出し自体が消えるため、生成されるコードは変わらない
+  template <typename T>
+  concept HasStats = requires { typename T::stats; };
+
+  template <typename Options>
+  inline void record_parse([[maybe_unused]] parse_status const status, [[maybe_unused]] parse_kernel const kernel) noexcept {
+    if constexpr (HasStats<Options>) {
+      Options::stats::on_parse(status, kernel);
+    }
+  }
+
+  template <typename Options>
+  inline void record_format() noexcept {
+    if constexpr (HasStats<Options>) {
+      Options::stats::on_format();
+    }
+  }
 }  // namespace detail
 
 /**
@@ -104,13 +148,15 @@ namespace detail {
  * 最後の48bit合成まで完全にベクトル演算（SIMDE経由）で行います
  *
  * @tparam Options パースの仕方を指定するオプション
+ * @tparam Kernel `Options::stats` に報告する処理の種類（通常は指定しない）
  * @param mac_str パース対象のMACアドレス文字列 (例: "AA:BB:CC:DD:EE:FF")
  * @return std::optional<std::uint64_t>
  */
-template <typename Options = parse_mac_options>
+template <typename Options = parse_mac_options, parse_kernel Kernel = parse_kernel::direct>
 [[nodiscard]]
 auto parse_mac_address_unsafe(std::string_view const mac) noexcept -> std::optional<std::uint64_t> {
   if (mac.size() < 17) {
+    detail::record_parse<Options>(parse_status::too_short, parse_kernel::none);
     return std::nullopt;
   }
 
@@ -132,6 +178,7 @@ auto parse_mac_address_unsafe(std::string_view const mac) noexcept -> std::optio
     auto const eq          = simde_mm256_cmpeq_epi8(delim_bytes, simde_mm256_set1_epi8(detail::delimiter_v<Options>));
     auto const mask        = static_cast<unsigned>(simde_mm256_movemask_epi8(eq));
     if ((mask & 0x1Fu) != 0x1Fu) {
+      detail::record_parse<Options>(parse_status::invalid_delimiter, Kernel);
       return std::nullopt;
     }
   }
@@ -175,6 +222,7 @@ auto parse_mac_address_unsafe(std::string_view const mac) noexcept -> std::optio
     // 先頭12バイト (AA BB CC DD EE FF) だけが検証対象
     auto const mask = static_cast<unsigned>(simde_mm256_movemask_epi8(is_valid));
     if ((mask & 0x0FFFu) != 0x0FFFu) {
+      detail::record_parse<Options>(parse_status::invalid_hex, Kernel);
       return std::nullopt;
     }
   }
@@ -207,6 +255,7 @@ auto parse_mac_address_unsafe(std::string_view const mac) noexcept -> std::optio
   auto const raw = static_cast<std::uint64_t>(simde_mm256_extract_epi64(mac_vector, 0));
 
   // 9. エンディアン変換
+  detail::record_parse<Options>(parse_status::success, Kernel);
   return std::byteswap(raw) >> 16;
 }
 
@@ -223,15 +272,23 @@ template <typename Options = parse_mac_options>
 [[nodiscard]]
 auto parse_mac_address(std::string_view const mac) noexcept -> std::optional<std::uint64_t> {
   if (mac.size() < 17) {
+    detail::record_parse<Options>(parse_status::too_short, parse_kernel::none);
     return std::nullopt;
   }
 
+  // 32byte以上読める場合はそのままロードしても範囲外に出ない
+  if (mac.size() >= 32) {
+    return parse_mac_address_unsafe<Options>(mac);
+  }
+
   // 256bitのロードは入力長(17)を越えるため、ゼロ埋めバッファにコピーしてからロードする
   auto       buf      = std::array<char, 32>{};
   auto const copy_len = (mac.size() < buf.size()) ? mac.size() : buf.size();
   std::memcpy(buf.data(), mac.data(), copy_len);
 
-  return parse_mac_address_unsafe<Options>(std::string_view{buf.data(), copy_len});
+  // 統計を取らない場合は直接ロードする経路と同じ実体を使い、生成されるコードを増やさない
+  constexpr auto kernel = detail::HasStats<Options> ? parse_kernel::copied : parse_kernel::direct;
+  return parse_mac_address_unsafe<Options, kernel>(std::string_view{buf.data(), copy_len});
 }
 
 /**
@@ -353,6 +410,7 @@ auto format_mac_address_to_buffer(std::uint64_t const mac, std::span<char, MAC_A
   simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(temp_hex_storage), hex_chars);
   buffer[16] = temp_hex_storage[11];
 
+  detail::record_format<Options>();
   return MAC_ADDRESS_STRING_LENGTH;
 }
 
@@ -374,6 +432,292 @@ auto format_mac_address(std::uint64_t const mac) -> std::string {
   return std::string{result_buf.data(), MAC_ADDRESS_STRING_LENGTH};
 }
 
+/**
+ * @brief `std::from_chars` と同じ形式で、MACアドレスをパースして読み終えた位置を返す
+ *
+ * 手書きのプロトコルパーサなどで、MACアドレスの直後から字句解析を続けるために使います
+ * `[first, last)` が32byte以上ある場合は、コピーせずに `parse_mac_address_unsafe` で直接パースします
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param first 入力の先頭（MACアドレスの1文字目）
+ * @param last 入力の終端
+ * @param value 成功した場合に48bit整数値が書き込まれる（失敗した場合は変更しない）
+ * @return 成功した場合は `{first + 17, std::errc{}}`、失敗した場合は `{first, std::errc::invalid_argument}`
+ */
+template <typename Options = parse_mac_options>
+auto from_chars(char const* const first, char const* const last, std::uint64_t& value, Options = {}) noexcept -> std::from_chars_result {
+  auto const mac    = std::string_view{first, static_cast<std::size_t>(last - first)};
+  auto const parsed = parse_mac_address<Options>(mac);
+  if (not parsed) {
+    return {first, std::errc::invalid_argument};
+  }
+  value = *parsed;
+  return {first + MAC_ADDRESS_STRING_LENGTH, std::errc{}};
+}
+
+/**
+ * @brief `std::to_chars` と同じ形式で、48bit整数をMACアドレス文字列として書き込み、書き終えた位置を返す
+ *
+ * 終端の`\0`は書き込みません
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param first 出力先の先頭
+ * @param last 出力先の終端
+ * @param value 48bit整数値（上位16bitは無視される）
+ * @return 成功した場合は `{first + 17, std::errc{}}`、領域が17バイトに満たない場合は `{last, std::errc::value_too_large}`
+ */
+template <typename Options = parse_mac_options>
+auto to_chars(char* const first, char* const last, std::uint64_t const value, Options = {}) noexcept -> std::to_chars_result {
+  if (last - first < static_cast<std::ptrdiff_t>(MAC_ADDRESS_STRING_LENGTH)) {
+    return {last, std::errc::value_too_large};
+  }
+  format_mac_address_to_buffer<Options>(value, std::span<char, MAC_ADDRESS_STRING_LENGTH>{first, MAC_ADDRESS_STRING_LENGTH});
+  return {first + MAC_ADDRESS_STRING_LENGTH, std::errc{}};
+}
+
+/**
+ * @brief 複数のMACアドレス文字列をまとめてパースする
+ *
+ * 各要素を `parse_mac_address` と同じ規則でパースし、結果を `out` の同じ位置に書き込みます
+ * `out` が `macs` より短い場合は `out` に収まる分だけ処理します
+ *
+ * @tparam Options パースの仕方を指定するオプション
+ * @param macs パース対象のMACアドレス文字列の並び
+ * @param out パース結果の書き込み先
+ * @return パースに成功した要素数
+ */
+template <typename Options = parse_mac_options>
+auto parse_mac_addresses(std::span<std::string_view const> const macs, std::span<std::optional<std::uint64_t>> const out) noexcept -> std::size_t {
+  auto const n       = (macs.size() < out.size()) ? macs.size() : out.size();
+  auto       success = std::size_t{0};
+  for (auto i = std::size_t{0}; i < n; ++i) {
+    out[i] = parse_mac_address<Options>(macs[i]);
+    success += out[i].has_value() ? 1 : 0;
+  }
+  return success;
+}
+
+/**
+ * @brief 複数の48bit整数をMACアドレス文字列に変換し、連続したバッファに書き込む
+ *
+ * i番目の要素は `buffer[i * 17, i * 17 + 17)` に書き込まれます（区切り文字や終端の`\0`は書き込みません）
+ * `buffer` が足りない場合は収まる分だけ変換します
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param macs 48bit整数値の並び
+ * @param buffer 出力先のバッファ（`macs.size() * 17` バイトが必要）
+ * @return 書き込まれた文字数
+ */
+template <typename Options = parse_mac_options>
+auto format_mac_addresses_to_buffer(std::span<std::uint64_t const> const macs, std::span<char> const buffer) -> std::size_t {
+  auto const capacity = buffer.size() / MAC_ADDRESS_STRING_LENGTH;
+  auto const n        = (macs.size() < capacity) ? macs.size() : capacity;
+  for (auto i = std::size_t{0}; i < n; ++i) {
+    format_mac_address_to_buffer<Options>(macs[i], buffer.subspan(i * MAC_ADDRESS_STRING_LENGTH).first<MAC_ADDRESS_STRING_LENGTH>());
+  }
+  return n * MAC_ADDRESS_STRING_LENGTH;
+}
+
+/**
+ * @brief 複数の48bit整数をMACアドレス文字列に変換し、アリーナ上に連続して配置する
+ *
+ * 全要素の文字列と `std::string_view` の配列を `arena` から1回の確保でまとめて取得し、
+ * `format_mac_addresses_to_buffer` で文字列を連続して書き込みます
+ * 要素ごとのヒープ確保が発生しないため、`std::pmr::monotonic_buffer_resource` などのバンプアロケータと組み合わせて使います
+ * 返されるビューと文字列は `arena` から確保した領域を指すため、`arena` が解放されるまで有効です
+ *
+ * @tparam Options デリミタと大文字・小文字を指定するオプション（validate_delimitersとvalidate_hexは無視される）
+ * @param macs 48bit整数値の並び
+ * @param arena 確保に使うメモリリソース
+ * @return 各要素の文字列を指すビューの並び（`macs` と同じ順序）
+ */
+template <typename Options = parse_mac_options>
+[[nodiscard]]
+auto format_mac_addresses_to_arena(std::span<std::uint64_t const> const macs, std::pmr::memory_resource& arena) -> std::span<std::string_view> {
+  if (macs.empty()) {
+    return {};
+  }
+
+  // [string_view * n][文字列 17 * n] の順に1ブロックで確保する
+  auto const views_bytes = macs.size() * sizeof(std::string_view);
+  auto const text_bytes  = macs.size() * MAC_ADDRESS_STRING_LENGTH;
+  auto*      block       = static_cast<char*>(arena.allocate(views_bytes + text_bytes, alignof(std::string_view)));
+  auto*      views       = reinterpret_cast<std::string_view*>(block);
+  auto*      text        = block + views_bytes;
+
+  format_mac_addresses_to_buffer<Options>(macs, std::span<char>{text, text_bytes});
+  for (auto i = std::size_t{0}; i < macs.size(); ++i) {
+    std::construct_at(views + i, text + i * MAC_ADDRESS_STRING_LENGTH, MAC_ADDRESS_STRING_LENGTH);
+  }
+  return {views, macs.size()};
+}
+
+/**
+ * @brief MACアドレス文字列の大文字・小文字とデリミタを正規化してバッファに書き込む
+ *
+ * 整数へのパースを経由せず、16byteのベクトル演算でデリミタの置換と英字の大文字・小文字変換を行います
+ * `mac.data()` と `buffer.data()` が同じ領域を指していても構いません（その場で書き換え）
+ * `InOptions` で検証が無効な場合、不正な入力に対する出力内容は規定しません
+ *
+ * @tparam InOptions 入力の検証方法とデリミタを指定するオプション
+ * @tparam OutOptions 出力のデリミタと大文字・小文字を指定するオプション
+ * @param mac 正規化対象のMACアドレス文字列（先頭17文字を使用）
+ * @param buffer 出力先のバッファ（17バイトが必要）
+ * @return 正規化に成功したかどうか
+ */
+template <typename InOptions = parse_mac_options, typename OutOptions = InOptions>
+[[nodiscard]]
+auto canonicalize_mac_address_to_buffer(std::string_view const mac, std::span<char, MAC_ADDRESS_STRING_LENGTH> buffer) noexcept -> bool {
+  if (mac.size() < MAC_ADDRESS_STRING_LENGTH) {
+    return false;
+  }
+
+  // 1. 先頭16byteをロードし、17文字目は個別に扱う
+  auto const chunk = simde_mm_loadu_si128(reinterpret_cast<simde__m128i const*>(mac.data()));
+  auto const last  = mac[16];
+
+  // デリミタ位置 2,5,8,11,14 のビットマスク
+  constexpr auto delim_bits = 0x4924u;
+
+  // 2. デリミタの位置検証
+  if constexpr (detail::validate_delimiters_v<InOptions>) {
+    auto const eq = static_cast<unsigned>(simde_mm_movemask_epi8(simde_mm_cmpeq_epi8(chunk, simde_mm_set1_epi8(detail::delimiter_v<InOptions>))));
+    if ((eq & delim_bits) != delim_bits) {
+      return false;
+    }
+  }
+
+  // 3. 16進数の英字 (a-f / A-F) の位置を求める
+  // 0x20 をORすると英字は小文字に揃い、数字とデリミタ(':' '-')は変化しない
+  auto const lower    = simde_mm_or_si128(chunk, simde_mm_set1_epi8(0x20));
+  auto const is_alpha = simde_mm_and_si128(simde_mm_cmpgt_epi8(lower, simde_mm_set1_epi8('a' - 1)), simde_mm_cmpgt_epi8(simde_mm_set1_epi8('f' + 1), lower));
+
+  auto const last_lower    = static_cast<char>(last | 0x20);
+  auto const last_is_alpha = last_lower >= 'a' and last_lower <= 'f';
+
+  // 4. 16進数の文字になっているのか検証
+  if constexpr (detail::validate_hex_v<InOptions>) {
+    auto const is_digit = simde_mm_and_si128(simde_mm_cmpgt_epi8(chunk, simde_mm_set1_epi8('0' - 1)), simde_mm_cmpgt_epi8(simde_mm_set1_epi8('9' + 1), chunk));
+    auto const valid    = static_cast<unsigned>(simde_mm_movemask_epi8(simde_mm_or_si128(is_digit, is_alpha))) | delim_bits;
+    if ((valid & 0xFFFFu) != 0xFFFFu or not(last_is_alpha or (last >= '0' and last <= '9'))) {
+      return false;
+    }
+  }
+
+  // 5. 英字の大文字・小文字を揃える
+  auto const case_bit = simde_mm_and_si128(is_alpha, simde_mm_set1_epi8(0x20));
+  auto const cased    = detail::uppercase_v<OutOptions> ? simde_mm_andnot_si128(case_bit, chunk) : simde_mm_or_si128(chunk, case_bit);
+
+  // 6. デリミタ位置に出力用のデリミタをブレンド
+  auto const delim_mask = simde_mm_setr_epi8(
+    // clang-format off
+     0,  0, -1,  0,  0, -1,  0,  0,
+    -1,  0,  0, -1,  0,  0, -1,  0
+    // clang-format on
+  );
+  auto const result_vec = simde_mm_blendv_epi8(cased, simde_mm_set1_epi8(detail::delimiter_v<OutOptions>), delim_mask);
+
+  // 7. 書き込み（17文字目は個別に変換）
+  simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(buffer.data()), result_vec);
+  if (last_is_alpha) {
+    buffer[16] = detail::uppercase_v<OutOptions> ? static_cast<char>(last & ~0x20) : last_lower;
+  } else {
+    buffer[16] = last;
+  }
+
+  return true;
+}
+
+namespace detail {
+  // スキャナが候補の確定に使うオプション（デリミタの位置は候補検出の時点で確定している）
+  template <char Delimiter>
+  struct scan_confirm_options {
+    static constexpr bool validate_delimiters = false;
+    static constexpr bool validate_hex        = true;
+    static constexpr char delimiter           = Delimiter;
+  };
+
+  // スキャナの1ウィンドウで判定する先頭位置の数と、1ウィンドウの処理に必要な読み取り可能バイト数
+  inline constexpr std::size_t scan_window_step     = 16;
+  inline constexpr std::size_t scan_window_readable = scan_window_step + 32;
+
+  /**
+   * @brief 32byte分のデリミタ一致ビットマスクから、MACアドレスの先頭候補を求める
+   *
+   * 先頭位置 s (0〜15) のうち、s+2, s+5, s+8, s+11, s+14 がすべてデリミタになっている位置のビットを立てる
+   */
+  [[nodiscard]]
+  constexpr auto mac_candidate_mask(std::uint32_t const delim_mask) noexcept -> std::uint32_t {
+    auto const m = delim_mask & (delim_mask >> 3) & (delim_mask >> 6) & (delim_mask >> 9) & (delim_mask >> 12);
+    return (m >> 2) & 0xFFFFu;
+  }
+
+  /**
+   * @brief 1ウィンドウ分（先頭候補16箇所）を走査する
+   *
+   * `window` から `scan_window_readable` バイトが読み取り可能である必要がある
+   */
+  template <typename Options, typename F>
+  auto scan_window(char const* const window, std::size_t const base, std::size_t& next, F& on_match) -> std::size_t {
+    auto const chunk = simde_mm256_loadu_si256(reinterpret_cast<simde__m256i const*>(window));
+    auto const eq    = simde_mm256_cmpeq_epi8(chunk, simde_mm256_set1_epi8(delimiter_v<Options>));
+    auto       cand  = mac_candidate_mask(static_cast<std::uint32_t>(simde_mm256_movemask_epi8(eq)));
+
+    auto count = std::size_t{0};
+    while (cand != 0) {
+      auto const s = static_cast<std::size_t>(std::countr_zero(cand));
+      cand &= cand - 1;
+      if (base + s < next) {
+        continue;
+      }
+      auto const v = parse_mac_address_unsafe<scan_confirm_options<delimiter_v<Options>>>(std::string_view{window + s, MAC_ADDRESS_STRING_LENGTH});
+      if (v) {
+        on_match(base + s, v.value());
+        next = base + s + MAC_ADDRESS_STRING_LENGTH;
+        ++count;
+      }
+    }
+    return count;
+  }
+}  // namespace detail
+
+/**
+ * @brief テキスト中に現れるMACアドレスを走査する
+ *
+ * 32byteずつデリミタの位置をベクトル比較して候補を求め、候補だけを `parse_mac_address_unsafe` で確定します
+ * デリミタは `Options::delimiter` を使用し、16進数文字の検証は `Options` に関わらず常に行います
+ * 見つかったMACアドレス同士は重なりません（見つかった位置の17文字後から走査を再開します）
+ * 末尾付近はローカルバッファにコピーしてから処理するため、`text` の範囲外は読みません
+ *
+ * @tparam Options デリミタを指定するオプション
+ * @param text 走査対象のテキスト
+ * @param on_match 見つかるたびに `on_match(std::size_t offset, std::uint64_t value)` の形で呼ばれる
+ * @return 見つかったMACアドレスの数
+ */
+template <typename Options = parse_mac_options, typename F>
+auto scan_mac_addresses(std::string_view const text, F&& on_match) -> std::size_t {
+  auto count = std::size_t{0};
+  auto next  = std::size_t{0};
+  auto pos   = std::size_t{0};
+
+  for (; pos + detail::scan_window_readable <= text.size(); pos += detail::scan_window_step) {
+    count += detail::scan_window<Options>(text.data() + pos, pos, next, on_match);
+  }
+
+  // 残りは読み取り可能なゼロ埋めバッファにコピーして同じ処理を行う
+  // ゼロはデリミタにも16進数文字にも一致しないため、テキスト末尾を越える候補は確定しない
+  if (pos < text.size()) {
+    auto       buf  = std::array<char, detail::scan_window_readable * 2>{};
+    auto const rest = text.size() - pos;
+    std::memcpy(buf.data(), text.data() + pos, rest);
+    for (auto local = std::size_t{0}; local < rest; local += detail::scan_window_step) {
+      count += detail::scan_window<Options>(buf.data() + local, pos + local, next, on_match);
+    }
+  }
+
+  return count;
+}
+
 }  // namespace macad_parser
 
 #endif /* MACAD_PARSER_HPP */
@@ -0,0 +1,173 @@
+// ベンチマーク結果をJSONに保存するCatch2のイベントリスナー
+//
+// 環境変数 MACAD_BENCH_RESULTS にパスを指定して実行すると、全ベンチマークの平均値と信頼区間を
+// マシンの識別情報（fingerprint）とともに書き出す。比較は tools/macad-bench-compare で行う
+//
+//   MACAD_BENCH_RESULTS=baseline.json ./build/test/all_test "[benchmark]"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+namespace {
+
+struct benchmark_record {
+  std::string   test_case;
+  std::string   name;
+  double        mean_ns;
+  double        lower_ns;
+  double        upper_ns;
+  double        stddev_ns;
+  double        confidence;
+  std::uint64_t samples;
+};
+
+auto json_escape(std::string_view const s) -> std::string {
+  auto out = std::string{};
+  out.reserve(s.size());
+  for (auto const c : s) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+        out += buf;
+      } else {
+        out += c;
+      }
+    }
+  }
+  return out;
+}
+
+auto cpu_model() -> std::string {
+  auto in   = std::ifstream{"/proc/cpuinfo"};
+  auto line = std::string{};
+  while (std::getline(in, line)) {
+    if (line.starts_with("model name") or line.starts_with("Model")) {
+      auto const colon = line.find(':');
+      if (colon != std::string::npos) {
+        auto const first = line.find_first_not_of(' ', colon + 1);
+        return first == std::string::npos ? std::string{} : line.substr(first);
+      }
+    }
+  }
+  return "unknown";
+}
+
+auto compiler() -> std::string {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_VER);
+#else
+  return "unknown";
+#endif
+}
+
+// SIMDeがネイティブ命令に置き換えられる命令セット（結果の比較可否の判断に使う）
+auto simd_level() -> std::string {
+#if defined(__AVX2__)
+  return "avx2";
+#elif defined(__SSE4_2__)
+  return "sse4.2";
+#elif defined(__ARM_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+// FNV-1a
+auto fingerprint_id(std::string_view const s) -> std::string {
+  auto h = std::uint64_t{0xCBF29CE484222325ull};
+  for (auto const c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001B3ull;
+  }
+  char buf[17];
+  std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+  return buf;
+}
+
+class benchmark_recorder final : public Catch::EventListenerBase {
+public:
+  using Catch::EventListenerBase::EventListenerBase;
+
+  void testCaseStarting(Catch::TestCaseInfo const& info) override {
+    test_case_ = info.name;
+  }
+
+  void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override {
+    records_.push_back(benchmark_record{
+      .test_case  = test_case_,
+      .name       = stats.info.name,
+      .mean_ns    = stats.mean.point.count(),
+      .lower_ns   = stats.mean.lower_bound.count(),
+      .upper_ns   = stats.mean.upper_bound.count(),
+      .stddev_ns  = stats.standardDeviation.point.count(),
+      .confidence = stats.mean.confidence_interval,
+      .samples    = stats.samples.size(),
+    });
+  }
+
+  void testRunEnded(Catch::TestRunStats const&) override {
+    auto const* const path = std::getenv("MACAD_BENCH_RESULTS");
+    if (path == nullptr or records_.empty()) {
+      return;
+    }
+    auto* const fp = std::fopen(path, "wb");
+    if (fp == nullptr) {
+      std::perror(path);
+      return;
+    }
+
+    auto const cpu     = cpu_model();
+    auto const threads = std::thread::hardware_concurrency();
+    auto const cc      = compiler();
+    auto const simd    = simd_level();
+    auto const id      = fingerprint_id(cpu + '\n' + std::to_string(threads) + '\n' + cc + '\n' + simd);
+
+    std::fprintf(fp, "{\n  \"fingerprint\": {\"id\": \"%s\", \"cpu\": \"%s\", \"threads\": %u, \"compiler\": \"%s\", \"simd\": \"%s\"},\n  \"benchmarks\": [\n", id.c_str(),
+                 json_escape(cpu).c_str(), threads, json_escape(cc).c_str(), simd.c_str());
+    for (auto i = std::size_t{0}; i < records_.size(); ++i) {
+      auto const& r = records_[i];
+      std::fprintf(fp,
+                   "    {\"test_case\": \"%s\", \"name\": \"%s\", \"mean_ns\": %.9g, \"lower_ns\": %.9g, \"upper_ns\": %.9g, \"stddev_ns\": %.9g, \"confidence\": %.3g, \"samples\": %llu}%s\n",
+                   json_escape(r.test_case).c_str(), json_escape(r.name).c_str(), r.mean_ns, r.lower_ns, r.upper_ns, r.stddev_ns, r.confidence,
+                   static_cast<unsigned long long>(r.samples), (i + 1 == records_.size()) ? "" : ",");
+    }
+    std::fputs("  ]\n}\n", fp);
+    std::fclose(fp);
+    std::fprintf(stderr, "benchmark results (%zu) written to %s\n", records_.size(), path);
+  }
+
+private:
+  std::string                   test_case_;
+  std::vector<benchmark_record> records_;
+};
+
+}  // namespace
+
+CATCH_REGISTER_LISTENER(benchmark_recorder)
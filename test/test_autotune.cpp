@@ -0,0 +1,193 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-autotune.hpp"
+#include "macad-parser-stats.hpp"
+#include "macad-parser-swar.hpp"
+#include "macad-parser.hpp"
+
+namespace {
+
+struct hyphen_lower_options {
+  static constexpr bool validate_delimiters = true;
+  static constexpr bool validate_hex        = true;
+  static constexpr char delimiter           = '-';
+  static constexpr bool uppercase           = false;
+};
+
+// 16進数文字・デリミタ・それ以外の文字を混ぜた17文字の入力
+auto make_fuzz_inputs() -> std::vector<std::string> {
+  constexpr auto alphabet = std::string_view{"0123456789abcdefABCDEF:-gG/@`\x7f\x80\xff "};
+  auto           inputs   = std::vector<std::string>{};
+  auto           seed     = std::uint64_t{42};
+  for (auto n = 0; n < 20000; ++n) {
+    auto s = std::string(macad_parser::MAC_ADDRESS_STRING_LENGTH, '\0');
+    for (auto i = std::size_t{0}; i < s.size(); ++i) {
+      seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+      // 多くの入力がほぼ正しい形になるよう、デリミタの位置はたいていデリミタにする
+      auto const r = seed >> 33;
+      s[i]         = (i % 3 == 2 and r % 4 != 0) ? ((r >> 8) % 2 == 0 ? ':' : '-') : alphabet[(r >> 8) % (r % 8 == 0 ? alphabet.size() : 22)];
+    }
+    inputs.push_back(std::move(s));
+  }
+  return inputs;
+}
+
+struct counted_options_tag;
+struct counted_options : macad_parser::parse_mac_options_strict {
+  using stats = macad_parser::thread_local_mac_stats<counted_options_tag>;
+};
+
+struct hex_only_options {
+  static constexpr bool validate_hex = true;
+};
+
+// 16進数を検証しないオプションでは、不正な入力に対する結果は決まっていないため正しい入力だけを比べる
+template <typename Options>
+void require_same_parse(std::vector<std::string> const& inputs) {
+  for (auto const& s : inputs) {
+    if (not macad_parser::detail::validate_hex_v<Options> and not macad_parser::parse_mac_address<hex_only_options>(s)) {
+      continue;
+    }
+    INFO(s);
+    REQUIRE(macad_parser::swar::parse_mac_address<Options>(s) == macad_parser::parse_mac_address<Options>(s));
+  }
+}
+
+template <typename Options>
+void require_same_format() {
+  for (auto const v : {0x000000000000ull, 0x0123456789ABull, 0xAABBCCDDEEFFull, 0xFFFFFFFFFFFFull, 0xA0B1C2D3E4F5ull}) {
+    auto simd = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    auto swar = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    macad_parser::format_mac_address_to_buffer<Options>(v, simd);
+    REQUIRE(macad_parser::swar::format_mac_address_to_buffer<Options>(v, swar) == macad_parser::MAC_ADDRESS_STRING_LENGTH);
+    REQUIRE(swar == simd);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("SWAR kernels agree with the SIMD kernels for every option") {
+  auto const inputs = make_fuzz_inputs();
+  require_same_parse<macad_parser::parse_mac_options>(inputs);
+  require_same_parse<macad_parser::parse_mac_options_strict>(inputs);
+  require_same_parse<hyphen_lower_options>(inputs);
+
+  REQUIRE(macad_parser::swar::parse_mac_address("aa:bb:cc:dd:ee:ff") == 0xAABBCCDDEEFFull);
+  REQUIRE_FALSE(macad_parser::swar::parse_mac_address("aa:bb:cc:dd:ee:f"));
+  REQUIRE_FALSE(macad_parser::swar::parse_mac_address<macad_parser::parse_mac_options_strict>("aa:bb:cc:dd:ee:fg"));
+
+  require_same_format<macad_parser::parse_mac_options>();
+  require_same_format<hyphen_lower_options>();
+}
+
+TEST_CASE("kernel plan is cached per host") {
+  auto const path = (std::filesystem::temp_directory_path() / "macad_parser_test_autotune.txt").string();
+  std::filesystem::remove(path);
+
+  REQUIRE_FALSE(macad_parser::load_mac_kernel_plan(path));
+
+  auto const plan = macad_parser::tune_mac_kernels(path, std::chrono::microseconds{200});
+  REQUIRE(std::filesystem::exists(path));
+  REQUIRE(macad_parser::load_mac_kernel_plan(path) == plan);
+
+  auto const other = macad_parser::mac_kernel_plan{macad_parser::mac_kernel::swar, macad_parser::mac_kernel::simd};
+  REQUIRE(macad_parser::save_mac_kernel_plan(path, other));
+  REQUIRE(macad_parser::tune_mac_kernels(path) == other);
+
+  SECTION("concurrent saves never publish a mixed file") {
+    auto const plans = std::array{macad_parser::mac_kernel_plan{macad_parser::mac_kernel::swar, macad_parser::mac_kernel::simd},
+                                  macad_parser::mac_kernel_plan{macad_parser::mac_kernel::simd, macad_parser::mac_kernel::swar}};
+    {
+      auto writers = std::vector<std::jthread>{};
+      for (auto const& p : plans) {
+        writers.emplace_back([&path, p] {
+          for (auto i = 0; i < 200; ++i) {
+            macad_parser::save_mac_kernel_plan(path, p);
+          }
+        });
+      }
+    }
+    auto const loaded = macad_parser::load_mac_kernel_plan(path);
+    REQUIRE(loaded);
+    REQUIRE((*loaded == plans[0] or *loaded == plans[1]));
+    // 一時ファイルは残らない
+    for (auto const& entry : std::filesystem::directory_iterator{std::filesystem::path{path}.parent_path()}) {
+      REQUIRE_FALSE(entry.path().filename().string().starts_with("macad_parser_test_autotune.txt.tmp"));
+    }
+  }
+
+  SECTION("a file from another host is ignored") {
+    auto* const fp = std::fopen(path.c_str(), "w");
+    REQUIRE(fp != nullptr);
+    std::fputs("macad-kernel-plan 1\nhost 0000000000000000\nparse swar\nformat swar\n", fp);
+    std::fclose(fp);
+    REQUIRE_FALSE(macad_parser::load_mac_kernel_plan(path));
+  }
+
+  SECTION("a malformed file is ignored") {
+    auto* const fp = std::fopen(path.c_str(), "w");
+    REQUIRE(fp != nullptr);
+    std::fputs("macad-kernel-plan 1\nparse swar\n", fp);
+    std::fclose(fp);
+    REQUIRE_FALSE(macad_parser::load_mac_kernel_plan(path));
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("calibration does not count toward the caller's stats") {
+  using options = counted_options;
+  auto const before = options::stats::snapshot();
+  static_cast<void>(macad_parser::calibrate_mac_kernels<options>(std::chrono::microseconds{200}));
+  auto const diff = options::stats::snapshot() - before;
+  REQUIRE(diff.failures() == 0);
+  REQUIRE(diff.count(macad_parser::parse_status::success) == 0);
+  REQUIRE(diff.formatted == 0);
+}
+
+TEST_CASE("calibration samples parse with the caller's options") {
+  // ':' 固定のサンプルだと、'-' 区切りで検証するオプションでは失敗する経路だけを計測してしまう
+  using options = macad_parser::detail::calibration_options<hyphen_lower_options>;
+  auto values   = std::array<std::uint64_t, macad_parser::detail::AUTOTUNE_ITEMS>{};
+  auto text     = std::array<char, macad_parser::detail::AUTOTUNE_ITEMS * macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+  macad_parser::detail::make_calibration_samples<options>(values, text);
+  for (auto i = std::size_t{0}; i < values.size(); ++i) {
+    auto const line = std::string_view{text.data() + i * macad_parser::MAC_ADDRESS_STRING_LENGTH, macad_parser::MAC_ADDRESS_STRING_LENGTH};
+    INFO(line);
+    REQUIRE(line[2] == '-');
+    REQUIRE(macad_parser::parse_mac_address<options>(line) == values[i]);
+    REQUIRE(macad_parser::swar::parse_mac_address<options>(line) == values[i]);
+  }
+  static_cast<void>(macad_parser::calibrate_mac_kernels<hyphen_lower_options>(std::chrono::microseconds{200}));
+}
+
+TEST_CASE("batch APIs give the same results with every kernel plan") {
+  auto const texts = std::array<std::string_view, 4>{"01:23:45:67:89:AB", "aa:bb:cc:dd:ee:ff", "AA:BB:CC:DD:EE:GG", "short"};
+  auto const macs  = std::array<std::uint64_t, 3>{0x0123456789ABull, 0xAABBCCDDEEFFull, 0x000000000001ull};
+
+  auto expected_values = std::array<std::optional<std::uint64_t>, texts.size()>{};
+  auto expected_text   = std::array<char, macs.size() * macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+  auto const expected_success = macad_parser::parse_mac_addresses<macad_parser::parse_mac_options_strict>(texts, expected_values);
+  macad_parser::format_mac_addresses_to_buffer(macs, expected_text);
+
+  for (auto const kernel : {macad_parser::mac_kernel::simd, macad_parser::mac_kernel::swar}) {
+    auto const plan   = macad_parser::mac_kernel_plan{kernel, kernel};
+    auto       values = std::array<std::optional<std::uint64_t>, texts.size()>{};
+    auto       text   = std::array<char, macs.size() * macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    REQUIRE(macad_parser::parse_mac_addresses<macad_parser::parse_mac_options_strict>(plan, texts, values) == expected_success);
+    REQUIRE(values == expected_values);
+    REQUIRE(macad_parser::format_mac_addresses_to_buffer(plan, macs, text) == text.size());
+    REQUIRE(text == expected_text);
+  }
+}
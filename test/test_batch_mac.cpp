@@ -0,0 +1,157 @@
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser.hpp"
+
+struct opt_dash_lower {
+  static constexpr char delimiter = '-';
+  static constexpr bool uppercase = false;
+};
+
+TEST_CASE("parse mac addresses (batch)") {
+  auto const macs = std::array<std::string_view, 4>{
+    "AA:BB:CC:DD:EE:FF",
+    "01:23:45:67:89:ab",
+    "01-23-45-67-89-AB",
+    "01:23",
+  };
+  auto out = std::array<std::optional<std::uint64_t>, 4>{};
+
+  auto const success = macad_parser::parse_mac_addresses<macad_parser::parse_mac_options_strict>(macs, out);
+  REQUIRE(success == 2);
+  REQUIRE(out[0] == 0xAABBCCDDEEFFull);
+  REQUIRE(out[1] == 0x0123456789ABull);
+  REQUIRE_FALSE(out[2].has_value());
+  REQUIRE_FALSE(out[3].has_value());
+}
+
+TEST_CASE("format mac addresses to buffer (batch)") {
+  auto const macs = std::array<std::uint64_t, 3>{0xAABBCCDDEEFFull, 0x0123456789ABull, 0xFFFF000000000001ull};
+
+  SECTION("formats contiguously") {
+    auto       buf     = std::string(macs.size() * macad_parser::MAC_ADDRESS_STRING_LENGTH, '\0');
+    auto const written = macad_parser::format_mac_addresses_to_buffer(macs, buf);
+    REQUIRE(written == buf.size());
+    REQUIRE(buf == "AA:BB:CC:DD:EE:FF01:23:45:67:89:AB00:00:00:00:00:01");
+  }
+
+  SECTION("stops when the buffer is too short") {
+    auto       buf     = std::string(macad_parser::MAC_ADDRESS_STRING_LENGTH * 2 - 1, '\0');
+    auto const written = macad_parser::format_mac_addresses_to_buffer<opt_dash_lower>(macs, buf);
+    REQUIRE(written == macad_parser::MAC_ADDRESS_STRING_LENGTH);
+    REQUIRE(buf.substr(0, written) == "aa-bb-cc-dd-ee-ff");
+  }
+}
+
+TEST_CASE("format mac addresses to arena") {
+  auto const macs = std::array<std::uint64_t, 3>{0xAABBCCDDEEFFull, 0x0123456789ABull, 0x000000000001ull};
+
+  SECTION("views point into one contiguous block") {
+    auto       arena = std::pmr::monotonic_buffer_resource{};
+    auto const views = macad_parser::format_mac_addresses_to_arena<opt_dash_lower>(macs, arena);
+    REQUIRE(views.size() == 3);
+    REQUIRE(views[0] == "aa-bb-cc-dd-ee-ff");
+    REQUIRE(views[1] == "01-23-45-67-89-ab");
+    REQUIRE(views[2] == "00-00-00-00-00-01");
+    REQUIRE(views[1].data() == views[0].data() + macad_parser::MAC_ADDRESS_STRING_LENGTH);
+    REQUIRE(views[2].data() == views[1].data() + macad_parser::MAC_ADDRESS_STRING_LENGTH);
+  }
+
+  SECTION("uses a single allocation") {
+    auto       buffer = std::array<std::byte, 256>{};
+    auto       arena  = std::pmr::monotonic_buffer_resource{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    auto const v      = macad_parser::format_mac_addresses_to_arena(macs, arena);
+    REQUIRE(v[0] == "AA:BB:CC:DD:EE:FF");
+    REQUIRE(static_cast<void const*>(v.data()) >= static_cast<void const*>(buffer.data()));
+    REQUIRE(static_cast<void const*>(v.data() + v.size()) <= static_cast<void const*>(buffer.data() + buffer.size()));
+  }
+
+  SECTION("empty input") {
+    auto arena = std::pmr::monotonic_buffer_resource{};
+    REQUIRE(macad_parser::format_mac_addresses_to_arena(std::span<std::uint64_t const>{}, arena).empty());
+  }
+}
+
+TEST_CASE("canonicalize mac address") {
+  auto out = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+
+  SECTION("changes case and delimiter") {
+    REQUIRE(macad_parser::canonicalize_mac_address_to_buffer<macad_parser::parse_mac_options_strict, opt_dash_lower>("AA:bB:0C:Dd:E9:FF", out));
+    REQUIRE(std::string_view{out.data(), out.size()} == "aa-bb-0c-dd-e9-ff");
+  }
+
+  SECTION("uppercases") {
+    REQUIRE(macad_parser::canonicalize_mac_address_to_buffer("aa:bb:cc:dd:ee:ff", out));
+    REQUIRE(std::string_view{out.data(), out.size()} == "AA:BB:CC:DD:EE:FF");
+  }
+
+  SECTION("works in place") {
+    auto text = std::string{"ab:cd:ef:01:23:4f"};
+    REQUIRE(macad_parser::canonicalize_mac_address_to_buffer<macad_parser::parse_mac_options, opt_dash_lower>(text, std::span<char, 17>{text.data(), 17}));
+    REQUIRE(text == "ab-cd-ef-01-23-4f");
+  }
+
+  SECTION("rejects invalid input with strict options") {
+    REQUIRE_FALSE(macad_parser::canonicalize_mac_address_to_buffer<macad_parser::parse_mac_options_strict>("AA-BB-CC-DD-EE-FF", out));
+    REQUIRE_FALSE(macad_parser::canonicalize_mac_address_to_buffer<macad_parser::parse_mac_options_strict>("AA:BB:CC:DD:EE:FG", out));
+    REQUIRE_FALSE(macad_parser::canonicalize_mac_address_to_buffer<macad_parser::parse_mac_options_strict>("AA:BB:CC:DD:EE:F", out));
+  }
+}
+
+TEST_CASE("scan mac addresses in text") {
+  auto const collect = [](std::string_view const text) {
+    auto found = std::vector<std::pair<std::size_t, std::uint64_t>>{};
+    macad_parser::scan_mac_addresses(text, [&](std::size_t const offset, std::uint64_t const value) { found.emplace_back(offset, value); });
+    return found;
+  };
+
+  SECTION("finds addresses at various offsets") {
+    auto const text  = std::string{"src=AA:BB:CC:DD:EE:FF dst=01:23:45:67:89:ab time=12:34:56\n"
+                                    "padding padding padding padding padding padding 11:22:33:44:55:66"};
+    auto const found = collect(text);
+    REQUIRE(found.size() == 3);
+    REQUIRE(found[0] == std::pair<std::size_t, std::uint64_t>{4, 0xAABBCCDDEEFFull});
+    REQUIRE(found[1] == std::pair<std::size_t, std::uint64_t>{26, 0x0123456789ABull});
+    REQUIRE(found[2].first == text.size() - 17);
+    REQUIRE(found[2].second == 0x112233445566ull);
+  }
+
+  SECTION("rejects non-hex candidates") {
+    REQUIRE(collect("GG:BB:CC:DD:EE:FF").empty());
+    REQUIRE(collect("AA:BB:CC:DD:EE:F").empty());
+  }
+
+  SECTION("matches do not overlap") {
+    auto const found = collect("AA:BB:CC:DD:EE:FF:00:11:22:33:44:55");
+    REQUIRE(found.size() == 2);
+    REQUIRE(found[0] == std::pair<std::size_t, std::uint64_t>{0, 0xAABBCCDDEEFFull});
+    REQUIRE(found[1] == std::pair<std::size_t, std::uint64_t>{18, 0x001122334455ull});
+  }
+
+  SECTION("finds every address in a long text") {
+    auto text = std::string{};
+    for (auto i = std::uint64_t{0}; i < 100; ++i) {
+      text += "x=";
+      text += macad_parser::format_mac_address(i * 0x010203040506ull);
+      text += (i % 3 == 0) ? "\n" : " ";
+    }
+    auto const found = collect(text);
+    REQUIRE(found.size() == 100);
+    for (auto i = std::uint64_t{0}; i < 100; ++i) {
+      REQUIRE(found[i].second == ((i * 0x010203040506ull) & 0xFFFFFFFFFFFFull));
+    }
+  }
+
+  SECTION("uses the delimiter of the options") {
+    auto const count = macad_parser::scan_mac_addresses<opt_dash_lower>("AA:BB:CC:DD:EE:FF 01-23-45-67-89-AB", [](std::size_t, std::uint64_t) {});
+    REQUIRE(count == 1);
+  }
+}
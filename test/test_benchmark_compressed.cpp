@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-compressed.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// 圧縮入力 Benchmarks（展開してからパース vs 展開とパースを重ねる）
+// ============================================================================
+
+#if MACAD_PARSER_HAS_ZLIB
+
+namespace {
+
+auto make_compressed_log(std::size_t const bytes) -> std::pair<std::string, std::string> {
+  auto text = std::string{};
+  for (auto i = std::uint64_t{0}; text.size() < bytes; ++i) {
+    text += "2024-01-01T00:00:00 dhcpd: DHCPACK on 10.0.0.1 to " + macad_parser::format_mac_address(test_support::mac_value(i)) + " via eth0\n";
+  }
+  auto stream = z_stream{};
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  auto compressed  = std::string(deflateBound(&stream, static_cast<uLong>(text.size())), '\0');
+  stream.next_in   = reinterpret_cast<Bytef*>(text.data());
+  stream.avail_in  = static_cast<uInt>(text.size());
+  stream.next_out  = reinterpret_cast<Bytef*>(compressed.data());
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return {std::move(text), std::move(compressed)};
+}
+
+}  // namespace
+
+TEST_CASE("Benchmark: gzip input, sequential vs overlapped", "[benchmark]") {
+  auto const [text, compressed] = make_compressed_log(std::size_t{8} << 20);
+
+  BENCHMARK("inflate all, then scan_mac_addresses 8MiB") {
+    auto out    = std::string(text.size(), '\0');
+    auto stream = z_stream{};
+    inflateInit2(&stream, 15 + 32);
+    stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    stream.avail_in  = static_cast<uInt>(compressed.size());
+    stream.next_out  = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    return macad_parser::scan_mac_addresses(out, [](std::size_t, std::uint64_t) {});
+  };
+
+  auto const source = [&] {
+    return [&compressed, pos = std::size_t{0}](std::span<char> const buffer) mutable {
+      auto const n = std::min(buffer.size(), compressed.size() - pos);
+      std::memcpy(buffer.data(), compressed.data() + pos, n);
+      pos += n;
+      return n;
+    };
+  };
+
+  BENCHMARK("scan_compressed_mac_addresses 8MiB") {
+    return macad_parser::scan_compressed_mac_addresses(source(), [](std::size_t, std::uint64_t) {}).macs;
+  };
+
+  auto const metrics = macad_parser::scan_compressed_mac_addresses(source(), [](std::size_t, std::uint64_t) {});
+  std::printf("gzip: decompress %.0f%% busy, parse %.0f%% busy, bottleneck: %s\n", metrics.decompress.utilization() * 100, metrics.parse.utilization() * 100,
+              metrics.bottleneck() == macad_parser::compressed_scan_metrics::stage::decompress ? "decompress" : "parse");
+}
+
+#endif
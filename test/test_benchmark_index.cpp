@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-index.hpp"
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// インデックスファイル Benchmarks（起動時の読み込みと検索）
+//
+// テキストからパースして整列する従来の起動処理と、書き出したインデックスファイルを開くだけの起動処理を比べる
+// ============================================================================
+
+TEST_CASE("Benchmark: startup from text vs mapped_mac_index", "[benchmark]") {
+  constexpr auto count = std::size_t{1} << 20;
+
+  auto macs = std::vector<std::uint64_t>{};
+  auto text = std::string{};
+  for (auto i = std::uint64_t{0}; i < count; ++i) {
+    macs.push_back(test_support::mac_value(i + 1));
+    text += macad_parser::format_mac_address(macs.back());
+    text += '\n';
+  }
+  auto const path = (std::filesystem::temp_directory_path() / "macad_parser_bench.macidx").string();
+  REQUIRE(macad_parser::write_mac_index(path, macs));
+
+  BENCHMARK("parse and sort 1M lines") {
+    auto sorted = std::vector<std::uint64_t>{};
+    sorted.reserve(count);
+    for (auto pos = std::size_t{0}; pos < text.size(); pos += macad_parser::MAC_ADDRESS_STRING_LENGTH + 1) {
+      sorted.push_back(macad_parser::parse_mac_address(std::string_view{text}.substr(pos, macad_parser::MAC_ADDRESS_STRING_LENGTH)).value_or(0));
+    }
+    std::sort(sorted.begin(), sorted.end());
+    return sorted.size();
+  };
+
+  BENCHMARK("mapped_mac_index::open 1M") {
+    return macad_parser::mapped_mac_index::open(path)->size();
+  };
+
+  auto sorted = macs;
+  std::sort(sorted.begin(), sorted.end());
+  auto const index = macad_parser::mapped_mac_index::open(path).value();
+
+  BENCHMARK("std::binary_search 4096 lookups") {
+    auto hits = std::size_t{0};
+    for (auto i = std::size_t{0}; i < 4096; ++i) {
+      hits += std::binary_search(sorted.begin(), sorted.end(), macs[(i * 7919) % count] + (i & 1)) ? 1 : 0;
+    }
+    return hits;
+  };
+
+  BENCHMARK("mapped_mac_index::contains 4096 lookups") {
+    auto hits = std::size_t{0};
+    for (auto i = std::size_t{0}; i < 4096; ++i) {
+      hits += index.contains(macs[(i * 7919) % count] + (i & 1)) ? 1 : 0;
+    }
+    return hits;
+  };
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,225 @@
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-padded.hpp"
+#include "macad-parser-swar.hpp"
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// 比較用のテーブル参照（LUT）カーネル（SWARカーネルは macad-parser-swar.hpp）
+// 検証なし・デリミタは任意（デフォルトOptionsと同じ条件）
+// ============================================================================
+
+namespace lut {
+
+constexpr auto HEX_VALUE = [] {
+  auto table = std::array<std::uint8_t, 256>{};
+  for (auto c = 0; c < 10; ++c) {
+    table['0' + c] = static_cast<std::uint8_t>(c);
+  }
+  for (auto c = 0; c < 6; ++c) {
+    table['A' + c] = table['a' + c] = static_cast<std::uint8_t>(10 + c);
+  }
+  return table;
+}();
+
+constexpr auto HEX_PAIR = [] {
+  auto table = std::array<std::array<char, 2>, 256>{};
+  for (auto v = 0; v < 256; ++v) {
+    table[v] = {"0123456789ABCDEF"[v >> 4], "0123456789ABCDEF"[v & 0x0F]};
+  }
+  return table;
+}();
+
+[[nodiscard]]
+auto parse_mac_address(std::string_view const mac) noexcept -> std::optional<std::uint64_t> {
+  if (mac.size() < 17) {
+    return std::nullopt;
+  }
+  auto value = std::uint64_t{0};
+  for (auto i = std::size_t{0}; i < 6; ++i) {
+    auto const hi = HEX_VALUE[static_cast<unsigned char>(mac[i * 3])];
+    auto const lo = HEX_VALUE[static_cast<unsigned char>(mac[i * 3 + 1])];
+    value         = (value << 8) | static_cast<std::uint64_t>((hi << 4) | lo);
+  }
+  return value;
+}
+
+void format_mac_address_to_buffer(std::uint64_t const mac, std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH> const buffer) noexcept {
+  for (auto i = std::size_t{0}; i < 6; ++i) {
+    auto const& pair  = HEX_PAIR[(mac >> (40 - 8 * i)) & 0xFF];
+    buffer[i * 3]     = pair[0];
+    buffer[i * 3 + 1] = pair[1];
+    if (i < 5) {
+      buffer[i * 3 + 2] = ':';
+    }
+  }
+}
+
+}  // namespace lut
+
+// ============================================================================
+// 依存チェーン（レイテンシ） / 独立ストリーム（スループット）の計測
+// ============================================================================
+
+namespace {
+
+constexpr auto CHAIN_LENGTH = std::size_t{1024};
+
+// CHAIN_LENGTH 個のMACアドレスを改行区切りで並べたパディング付きの入力
+auto make_input() -> macad_parser::padded_string {
+  return test_support::make_mac_lines(CHAIN_LENGTH * test_support::LINE_LENGTH);
+}
+
+auto line_at(macad_parser::padded_string const& input, std::size_t const i) -> macad_parser::padded_string_view {
+  return input.view().substr(i * test_support::LINE_LENGTH, macad_parser::MAC_ADDRESS_STRING_LENGTH);
+}
+
+// 次に読む行が直前のパース結果で決まるため、前の変換が終わるまで次を始められない
+template <typename Parse>
+auto parse_dependent(macad_parser::padded_string const& input, Parse&& parse) -> std::uint64_t {
+  auto idx = std::size_t{0};
+  auto acc = std::uint64_t{0};
+  for (auto i = std::size_t{0}; i < CHAIN_LENGTH; ++i) {
+    auto const v = parse(line_at(input, idx)).value_or(0);
+    acc += v;
+    idx = static_cast<std::size_t>(v ^ i) & (CHAIN_LENGTH - 1);
+  }
+  return acc;
+}
+
+// 各行を順に変換する。互いに依存しないため、複数の変換がCPU内で重なって実行される
+template <typename Parse>
+auto parse_independent(macad_parser::padded_string const& input, Parse&& parse) -> std::uint64_t {
+  auto acc = std::uint64_t{0};
+  for (auto i = std::size_t{0}; i < CHAIN_LENGTH; ++i) {
+    acc += parse(line_at(input, i)).value_or(0);
+  }
+  return acc;
+}
+
+// 次に変換する値が直前の出力文字列から決まる
+template <typename Format>
+auto format_dependent(Format&& format) -> std::uint64_t {
+  auto buffer = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+  auto value  = std::uint64_t{0x0123456789ABull};
+  for (auto i = std::size_t{0}; i < CHAIN_LENGTH; ++i) {
+    format(value, buffer);
+    auto bits = std::uint64_t{};
+    std::memcpy(&bits, buffer.data() + 9, sizeof(bits));
+    value = (bits * 0x9E3779B97F4A7C15ull + i) >> 16;
+  }
+  return value;
+}
+
+template <typename Format>
+auto format_independent(std::vector<std::uint64_t> const& values, std::vector<char>& out, Format&& format) -> char {
+  for (auto i = std::size_t{0}; i < values.size(); ++i) {
+    format(values[i], std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{out.data() + i * macad_parser::MAC_ADDRESS_STRING_LENGTH, macad_parser::MAC_ADDRESS_STRING_LENGTH});
+  }
+  return out[out.size() / 2];
+}
+
+auto simd_parse(macad_parser::padded_string_view const s) {
+  return macad_parser::parse_mac_address(s);
+}
+
+auto swar_parse(std::string_view const s) {
+  return macad_parser::swar::parse_mac_address(s);
+}
+
+auto lut_parse(std::string_view const s) {
+  return lut::parse_mac_address(s);
+}
+
+void simd_format(std::uint64_t const v, std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH> const out) {
+  macad_parser::format_mac_address_to_buffer(v, out);
+}
+
+void swar_format(std::uint64_t const v, std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH> const out) {
+  macad_parser::swar::format_mac_address_to_buffer(v, out);
+}
+
+void lut_format(std::uint64_t const v, std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH> const out) {
+  lut::format_mac_address_to_buffer(v, out);
+}
+
+// 比較用の LUT カーネルが SIMD カーネルと同じ結果を返すことを、計測の前に確かめる
+void require_lut_matches_simd(macad_parser::padded_string const& input) {
+  for (auto i = std::size_t{0}; i < CHAIN_LENGTH; ++i) {
+    auto const line     = line_at(input, i);
+    auto const expected = macad_parser::parse_mac_address(line);
+    REQUIRE(lut::parse_mac_address(line) == expected);
+    auto text = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    lut::format_mac_address_to_buffer(*expected, text);
+    REQUIRE(std::string_view{text.data(), text.size()} == std::string_view{line});
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Benchmark: parse latency (dependent chain)", "[benchmark][latency]") {
+  auto const input = make_input();
+  require_lut_matches_simd(input);
+
+  BENCHMARK("SIMD parse x1024 (dependent)") {
+    return parse_dependent(input, simd_parse);
+  };
+  BENCHMARK("SWAR parse x1024 (dependent)") {
+    return parse_dependent(input, swar_parse);
+  };
+  BENCHMARK("LUT parse x1024 (dependent)") {
+    return parse_dependent(input, lut_parse);
+  };
+}
+
+TEST_CASE("Benchmark: parse throughput (independent stream)", "[benchmark][throughput]") {
+  auto const input = make_input();
+
+  BENCHMARK("SIMD parse x1024 (independent)") {
+    return parse_independent(input, simd_parse);
+  };
+  BENCHMARK("SWAR parse x1024 (independent)") {
+    return parse_independent(input, swar_parse);
+  };
+  BENCHMARK("LUT parse x1024 (independent)") {
+    return parse_independent(input, lut_parse);
+  };
+}
+
+TEST_CASE("Benchmark: format latency (dependent chain)", "[benchmark][latency]") {
+  BENCHMARK("SIMD format x1024 (dependent)") {
+    return format_dependent(simd_format);
+  };
+  BENCHMARK("SWAR format x1024 (dependent)") {
+    return format_dependent(swar_format);
+  };
+  BENCHMARK("LUT format x1024 (dependent)") {
+    return format_dependent(lut_format);
+  };
+}
+
+TEST_CASE("Benchmark: format throughput (independent stream)", "[benchmark][throughput]") {
+  auto const values = test_support::mac_values(CHAIN_LENGTH);
+  auto out = std::vector<char>(values.size() * macad_parser::MAC_ADDRESS_STRING_LENGTH);
+
+  BENCHMARK("SIMD format x1024 (independent)") {
+    return format_independent(values, out, simd_format);
+  };
+  BENCHMARK("SWAR format x1024 (independent)") {
+    return format_independent(values, out, swar_format);
+  };
+  BENCHMARK("LUT format x1024 (independent)") {
+    return format_independent(values, out, lut_format);
+  };
+}
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-lazy.hpp"
+#include "macad-parser.hpp"
+
+// ============================================================================
+// 遅延パース Benchmarks（前段のフィルタで90%のレコードが捨てられる場合）
+// ============================================================================
+
+namespace {
+
+struct record {
+  std::uint32_t    port;
+  std::string_view mac;
+};
+
+}  // namespace
+
+TEST_CASE("Benchmark: eager parse vs lazy_mac with 10% survivors", "[benchmark]") {
+  constexpr auto count = std::size_t{4096};
+
+  auto texts = std::vector<std::string>{};
+  for (auto i = std::uint64_t{0}; i < count; ++i) {
+    texts.push_back(macad_parser::format_mac_address(i * 0x0000010203040506ull));
+  }
+  auto records = std::vector<record>{};
+  for (auto i = std::size_t{0}; i < count; ++i) {
+    records.push_back(record{static_cast<std::uint32_t>(i % 10), texts[i]});
+  }
+  auto const target = texts[count / 2 + 7];
+
+  BENCHMARK("eager parse, then filter 4096") {
+    auto sum = std::uint64_t{0};
+    for (auto const& r : records) {
+      auto const mac = macad_parser::parse_mac_address(r.mac);
+      if (r.port == 7) {
+        sum += mac.value_or(0);
+      }
+    }
+    return sum;
+  };
+
+  BENCHMARK("filter, then materialize survivors 4096") {
+    auto lazy      = std::vector<macad_parser::lazy_mac<>>{};
+    auto survivors = std::vector<std::size_t>{};
+    lazy.reserve(records.size());
+    for (auto const& r : records) {
+      if (r.port == 7) {
+        survivors.push_back(lazy.size());
+      }
+      lazy.emplace_back(r.mac);
+    }
+    macad_parser::materialize_mac_addresses(lazy, survivors);
+    auto sum = std::uint64_t{0};
+    for (auto const i : survivors) {
+      sum += lazy[i].value().value_or(0);
+    }
+    return sum;
+  };
+
+  auto const value = macad_parser::parse_mac_address(target).value_or(0);
+
+  BENCHMARK("parse and compare 4096") {
+    auto hits = std::size_t{0};
+    for (auto const& r : records) {
+      hits += (macad_parser::parse_mac_address(r.mac) == value) ? 1 : 0;
+    }
+    return hits;
+  };
+
+  BENCHMARK("mac_text_matcher 4096") {
+    auto const key  = macad_parser::mac_text_matcher{value};
+    auto       hits = std::size_t{0};
+    for (auto const& r : records) {
+      hits += key.matches(r.mac) ? 1 : 0;
+    }
+    return hits;
+  };
+}
@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-lines.hpp"
+#include "macad-parser.hpp"
+
+// ============================================================================
+// 行インデックス Benchmarks（1行に「MACアドレス + 他の列」のファイルで N 行目をパースする）
+// ============================================================================
+
+TEST_CASE("Benchmark: line index build and random access", "[benchmark]") {
+  constexpr auto lines = std::size_t{100000};
+
+  auto text = std::string{};
+  for (auto i = std::uint64_t{0}; i < lines; ++i) {
+    text += macad_parser::format_mac_address(0x020000000000ull + i * 0x10001ull);
+    text += ",2024-01-01T00:00:00,port" + std::to_string(i % 48) + ",vlan" + std::to_string(i % 4094) + '\n';
+  }
+  auto const index = macad_parser::mac_line_index::build(text);
+  REQUIRE(index.size() == lines);
+
+  // 一定の歩幅で行を選ぶ（連続しない行への参照）
+  auto targets = std::vector<std::size_t>{};
+  for (auto i = std::size_t{0}; i < 64; ++i) {
+    targets.push_back((i * 7919) % lines);
+  }
+
+  BENCHMARK("mac_line_index::build 100k lines") {
+    return macad_parser::mac_line_index::build(text).size();
+  };
+
+  BENCHMARK("rescan to line N, then parse 64") {
+    auto sum = std::uint64_t{0};
+    for (auto const target : targets) {
+      auto pos = std::size_t{0};
+      for (auto n = std::size_t{0}; n < target; ++n) {
+        pos = text.find('\n', pos) + 1;
+      }
+      sum += macad_parser::parse_mac_address(std::string_view{text}.substr(pos)).value_or(0);
+    }
+    return sum;
+  };
+
+  BENCHMARK("mac_line_index::parse 64") {
+    auto sum = std::uint64_t{0};
+    for (auto const target : targets) {
+      sum += index.parse(text, target).value_or(0);
+    }
+    return sum;
+  };
+
+  BENCHMARK("mac_line_index::parse_lines 100k") {
+    auto out = std::vector<std::optional<std::uint64_t>>(lines);
+    return index.parse_lines(text, 0, out);
+  };
+}
@@ -1,13 +1,18 @@
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cstdint>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "catch2/catch_all.hpp"
 
 #include "macad-parser.hpp"
+#include "macad-parser-intern.hpp"
+#include "macad-parser-unicode.hpp"
 
 // ============================================================================
 // ベースラインとなるSIMDを使わないナイーブな実装
@@ -321,3 +326,94 @@ TEST_CASE("Benchmark: delimiter comparison", "[benchmark]") {
     return macad_parser::format_mac_address<opt_dash>(TEST_MAC_VAL);
   };
 }
+
+// ============================================================================
+// バッチフォーマット Benchmarks
+// ============================================================================
+
+TEST_CASE("Benchmark: batch format (vector<string> vs arena)", "[benchmark]") {
+  auto macs = std::vector<std::uint64_t>(4096);
+  for (auto i = std::size_t{0}; i < macs.size(); ++i) {
+    macs[i] = TEST_MAC_VAL ^ (i * 0x0001000100010001ull);
+  }
+
+  BENCHMARK("format 4096 to vector<string>") {
+    auto out = std::vector<std::string>{};
+    out.reserve(macs.size());
+    for (auto const mac : macs) {
+      out.push_back(macad_parser::format_mac_address(mac));
+    }
+    return out;
+  };
+
+  auto storage = std::vector<std::byte>(macs.size() * (sizeof(std::string_view) + macad_parser::MAC_ADDRESS_STRING_LENGTH) + 64);
+  BENCHMARK("format 4096 to arena") {
+    auto       arena = std::pmr::monotonic_buffer_resource{storage.data(), storage.size()};
+    auto const views = macad_parser::format_mac_addresses_to_arena(macs, arena);
+    return views.back().size();
+  };
+}
+
+// ============================================================================
+// 文字列キャッシュ Benchmarks
+// ============================================================================
+
+TEST_CASE("Benchmark: mac_string_intern vs format", "[benchmark]") {
+  // 少数のMACアドレスが大半を占めるフローログを想定
+  auto macs = std::vector<std::uint64_t>(4096);
+  for (auto i = std::size_t{0}; i < macs.size(); ++i) {
+    macs[i] = TEST_MAC_VAL + (i * 0x9E3779B1ull) % 16;
+  }
+  auto cache = macad_parser::mac_string_intern<>{};
+
+  BENCHMARK("format 4096 hot values to buffer") {
+    auto buf = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    auto sum = std::size_t{0};
+    for (auto const mac : macs) {
+      macad_parser::format_mac_address_to_buffer(mac, buf);
+      sum += static_cast<unsigned char>(buf[16]);
+    }
+    return sum;
+  };
+
+  BENCHMARK("intern 4096 hot values") {
+    auto sum = std::size_t{0};
+    for (auto const mac : macs) {
+      sum += static_cast<unsigned char>(cache(mac)[16]);
+    }
+    return sum;
+  };
+}
+
+// ============================================================================
+// UTF-16 Benchmarks（1文字ずつ狭めてからパース vs ベクトルで狭める）
+// ============================================================================
+
+TEST_CASE("Benchmark: UTF-16 parse and format", "[benchmark]") {
+  // どちらもスタック上の配列に変換し、ヒープ確保を含めずに狭める・広げる処理だけを比べる
+  auto const wide = std::u16string(TEST_MAC_STR, TEST_MAC_STR + macad_parser::MAC_ADDRESS_STRING_LENGTH);
+
+  BENCHMARK("parse UTF-16 (scalar narrowing + parse) - baseline") {
+    auto narrow = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    std::transform(wide.begin(), wide.end(), narrow.begin(), [](char16_t const c) { return c < 0x80 ? static_cast<char>(c) : '\xFF'; });
+    return macad_parser::parse_mac_address<macad_parser::parse_mac_options_strict>(std::string_view{narrow.data(), narrow.size()});
+  };
+
+  BENCHMARK("parse UTF-16 (packus narrowing)") {
+    return macad_parser::parse_mac_address<macad_parser::parse_mac_options_strict>(std::u16string_view{wide});
+  };
+
+  BENCHMARK("format UTF-16 (format + scalar widening) - baseline") {
+    auto narrow = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    auto out    = std::array<char16_t, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    macad_parser::format_mac_address_to_buffer(TEST_MAC_VAL, narrow);
+    std::copy(narrow.begin(), narrow.end(), out.begin());
+    return out;
+  };
+
+  BENCHMARK("format UTF-16 (vector widening)") {
+    auto out = std::array<char16_t, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    macad_parser::format_mac_address_to_buffer(TEST_MAC_VAL, out);
+    return out;
+  };
+}
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// Options の全組み合わせを型リストから生成して測るベンチマーク
+//
+// validate_delimiters × validate_hex × delimiter × uppercase の直積をコンパイル時に展開し、
+// 組み合わせごとにパースとフォーマットを測る。if constexpr の分岐の組み合わせによって
+// 想定外に遅くなるものがないかを、行列形式の一覧で確認する
+//
+// オプションの軸を増やすときは option_axes に axis を足し、matrix_options と
+// 各ラムダのテンプレート引数を同じ順に増やす
+// ============================================================================
+
+namespace {
+
+constexpr auto ITEMS              = std::size_t{1024};
+constexpr auto MIN_MEASURE_TIME   = std::chrono::milliseconds{20};
+constexpr auto SLOWDOWN_THRESHOLD = 1.25;
+
+// 1つの軸が取りうる値の一覧
+template <auto... Values>
+struct axis {};
+
+// validate_delimiters, validate_hex, delimiter, uppercase の順
+using option_axes = std::tuple<axis<false, true>, axis<false, true>, axis<':', '-'>, axis<true, false>>;
+
+template <bool ValidateDelimiters, bool ValidateHex, char Delimiter, bool Uppercase>
+struct matrix_options {
+  static constexpr bool validate_delimiters = ValidateDelimiters;
+  static constexpr bool validate_hex        = ValidateHex;
+  static constexpr char delimiter           = Delimiter;
+  static constexpr bool uppercase           = Uppercase;
+};
+
+template <typename F, auto... Chosen>
+void for_each_combination(F& f, axis<Chosen...>) {
+  f.template operator()<Chosen...>();
+}
+
+template <typename F, auto... Chosen, auto... Values, typename... Rest>
+void for_each_combination(F& f, axis<Chosen...>, axis<Values...>, Rest... rest) {
+  (for_each_combination(f, axis<Chosen..., Values>{}, rest...), ...);
+}
+
+// Axes の直積のすべての組み合わせについて f.template operator()<値...>() を呼ぶ
+template <typename Axes, typename F>
+void for_each_options(F&& f) {
+  [&]<typename... A>(std::tuple<A...>*) { for_each_combination(f, axis<>{}, A{}...); }(static_cast<Axes*>(nullptr));
+}
+
+template <bool ValidateDelimiters, bool ValidateHex, char Delimiter, bool Uppercase>
+auto options_name() -> std::string {
+  return std::string{"vd="} + (ValidateDelimiters ? "1" : "0") + " vh=" + (ValidateHex ? "1" : "0") + " delim='" + Delimiter + "' " + (Uppercase ? "upper" : "lower");
+}
+
+// Options の形式（デリミタ・大文字/小文字）で整形した入力
+template <typename Options>
+auto make_texts(std::vector<std::uint64_t> const& values) -> std::vector<std::string> {
+  auto texts = std::vector<std::string>{};
+  texts.reserve(values.size());
+  for (auto const v : values) {
+    texts.push_back(macad_parser::format_mac_address<Options>(v));
+  }
+  return texts;
+}
+
+template <typename Options>
+auto parse_all(std::vector<std::string> const& texts) -> std::uint64_t {
+  auto acc = std::uint64_t{0};
+  for (auto const& t : texts) {
+    acc += macad_parser::parse_mac_address<Options>(t).value_or(1);
+  }
+  return acc;
+}
+
+template <typename Options>
+auto format_all(std::vector<std::uint64_t> const& values, std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH> const buffer) -> std::uint64_t {
+  auto acc = std::uint64_t{0};
+  for (auto const v : values) {
+    macad_parser::format_mac_address_to_buffer<Options>(v, buffer);
+    acc += static_cast<std::uint64_t>(buffer[16]);
+  }
+  return acc;
+}
+
+// 合計が MIN_MEASURE_TIME を超えるまで繰り返し、1件あたりのナノ秒を返す
+template <typename F>
+auto ns_per_item(F&& pass) -> double {
+  using clock   = std::chrono::steady_clock;
+  auto sink     = pass();
+  auto passes   = std::size_t{0};
+  auto const t0 = clock::now();
+  auto now      = t0;
+  do {
+    sink += pass();
+    ++passes;
+    now = clock::now();
+  } while (now - t0 < MIN_MEASURE_TIME);
+  static_cast<void>(sink);
+  return std::chrono::duration<double, std::nano>(now - t0).count() / static_cast<double>(passes * ITEMS);
+}
+
+struct matrix_cell {
+  std::string row;
+  std::string column;
+  double      ns;
+};
+
+// 行は検証オプション、列はデリミタと大文字/小文字。行の中で最速のセルより
+// SLOWDOWN_THRESHOLD 倍以上遅いセルに印を付ける（デリミタや大文字/小文字で速度は変わらないはず）
+void print_matrix(char const* const title, std::vector<matrix_cell> const& cells) {
+  auto rows    = std::vector<std::string>{};
+  auto columns = std::vector<std::string>{};
+  for (auto const& c : cells) {
+    if (std::find(rows.begin(), rows.end(), c.row) == rows.end()) {
+      rows.push_back(c.row);
+    }
+    if (std::find(columns.begin(), columns.end(), c.column) == columns.end()) {
+      columns.push_back(c.column);
+    }
+  }
+
+  std::printf("\n%s (ns/item, * = %.2fx slower than the fastest in its row)\n%-10s", title, SLOWDOWN_THRESHOLD, "");
+  for (auto const& col : columns) {
+    std::printf(" %14s", col.c_str());
+  }
+  std::printf("\n");
+  for (auto const& row : rows) {
+    auto fastest = 0.0;
+    for (auto const& c : cells) {
+      if (c.row == row and (fastest == 0.0 or c.ns < fastest)) {
+        fastest = c.ns;
+      }
+    }
+    std::printf("%-10s", row.c_str());
+    for (auto const& col : columns) {
+      auto const it = std::find_if(cells.begin(), cells.end(), [&](auto const& c) { return c.row == row and c.column == col; });
+      std::printf(" %13.2f%c", it->ns, it->ns > fastest * SLOWDOWN_THRESHOLD ? '*' : ' ');
+    }
+    std::printf("\n");
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Options matrix: every combination round-trips") {
+  auto combinations = 0;
+  for_each_options<option_axes>([&]<bool VD, bool VH, char D, bool U>() {
+    using options     = matrix_options<VD, VH, D, U>;
+    auto const values = test_support::mac_values(ITEMS);
+    auto const texts  = make_texts<options>(values);
+    INFO(options_name<VD, VH, D, U>());
+    for (auto i = std::size_t{0}; i < ITEMS; ++i) {
+      REQUIRE(texts[i][2] == D);
+      REQUIRE(macad_parser::parse_mac_address<options>(texts[i]) == values[i]);
+    }
+    ++combinations;
+  });
+  REQUIRE(combinations == 2 * 2 * 2 * 2);
+}
+
+TEST_CASE("Benchmark: parse and format for every Options combination", "[benchmark][matrix]") {
+  for_each_options<option_axes>([&]<bool VD, bool VH, char D, bool U>() {
+    using options     = matrix_options<VD, VH, D, U>;
+    auto const name   = options_name<VD, VH, D, U>();
+    auto const values = test_support::mac_values(ITEMS);
+    auto const texts  = make_texts<options>(values);
+    auto       buffer = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+
+    BENCHMARK("parse x1024 [" + name + "]") {
+      return parse_all<options>(texts);
+    };
+    BENCHMARK("format x1024 [" + name + "]") {
+      return format_all<options>(values, buffer);
+    };
+  });
+}
+
+TEST_CASE("Benchmark: Options matrix summary", "[benchmark][matrix]") {
+  auto parse  = std::vector<matrix_cell>{};
+  auto format = std::vector<matrix_cell>{};
+  for_each_options<option_axes>([&]<bool VD, bool VH, char D, bool U>() {
+    using options     = matrix_options<VD, VH, D, U>;
+    auto const values = test_support::mac_values(ITEMS);
+    auto const texts  = make_texts<options>(values);
+    auto       buffer = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    auto const row    = std::string{"vd="} + (VD ? "1" : "0") + " vh=" + (VH ? "1" : "0");
+    auto const column = std::string{"'"} + D + "' " + (U ? "upper" : "lower");
+
+    parse.push_back(matrix_cell{row, column, ns_per_item([&] { return parse_all<options>(texts); })});
+    format.push_back(matrix_cell{row, column, ns_per_item([&] { return format_all<options>(values, buffer); })});
+  });
+
+  print_matrix("parse_mac_address", parse);
+  print_matrix("format_mac_address_to_buffer", format);
+  REQUIRE(parse.size() == 2 * 2 * 2 * 2);
+  REQUIRE(format.size() == parse.size());
+}
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-padded.hpp"
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// スレッド数によるスケーリングとメモリ帯域の飽和点を測る Benchmark
+//
+// 各スレッドは自分専用のバッファ（スレッド上で確保・初期化するため、NUMAでは近いノードに置かれる）を
+// 繰り返しパース/フォーマットする。1..N スレッドの合計GB/sと、1スレッドに対する効率を表示する
+// 時間がかかるため通常のテストでは実行しない（"[scaling]" を指定して実行する）
+//
+//   MACAD_BENCH_THREADS       最大スレッド数（デフォルトは使用可能なCPU数）
+//   MACAD_BENCH_BYTES         1スレッドあたりのバッファサイズ（例: 64M、256m。デフォルト 64M）
+//   MACAD_BENCH_PIN           1 のとき、i番目のスレッドをi番目の使用可能なCPUに固定する（Linuxのみ）
+//   MACAD_BENCH_NUMA_NODE     指定したNUMAノードのCPUだけを使う（Linuxのみ。固定も有効になる）
+// ============================================================================
+
+namespace {
+
+using test_support::LINE_LENGTH;
+
+constexpr auto DEFAULT_BYTES     = std::size_t{64} << 20;
+constexpr auto MIN_MEASURE_TIME  = std::chrono::milliseconds{200};
+constexpr auto FLATTEN_THRESHOLD = 0.10;
+
+// 環境変数が "1" のときだけ有効にする（未設定や "0" は無効）
+auto env_is_one(char const* const name) -> bool {
+  auto const* const env = std::getenv(name);
+  return env != nullptr and std::string_view{env} == "1";
+}
+
+// "0-3,8-11" 形式のCPUリストを読む
+auto parse_cpu_list(std::string_view s) -> std::vector<int> {
+  auto cpus = std::vector<int>{};
+  while (not s.empty()) {
+    auto const comma = s.find(',');
+    auto const item  = s.substr(0, comma);
+    auto const end   = item.data() + item.size();
+    auto       first = 0;
+    auto       res   = std::from_chars(item.data(), end, first);
+    auto       last  = first;
+    if (res.ec == std::errc{} and res.ptr != end and *res.ptr == '-') {
+      res = std::from_chars(res.ptr + 1, end, last);
+    }
+    // 読めない要素は飛ばす
+    if (res.ec == std::errc{} and res.ptr == end) {
+      for (auto c = first; c <= last; ++c) {
+        cpus.push_back(c);
+      }
+    }
+    s = (comma == std::string_view::npos) ? std::string_view{} : s.substr(comma + 1);
+  }
+  return cpus;
+}
+
+// 使用可能なCPUの一覧（NUMAノードの指定があればそのノードのCPUに絞る）
+auto available_cpus() -> std::vector<int> {
+  auto cpus = std::vector<int>{};
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (auto c = 0; c < CPU_SETSIZE; ++c) {
+      if (CPU_ISSET(c, &set)) {
+        cpus.push_back(c);
+      }
+    }
+  }
+  if (auto const* const node = std::getenv("MACAD_BENCH_NUMA_NODE")) {
+    auto in   = std::ifstream{std::string{"/sys/devices/system/node/node"} + node + "/cpulist"};
+    auto list = std::string{};
+    if (std::getline(in, list)) {
+      auto const on_node = parse_cpu_list(list);
+      std::erase_if(cpus, [&](int const c) { return std::find(on_node.begin(), on_node.end(), c) == on_node.end(); });
+    } else {
+      std::fprintf(stderr, "scaling: NUMA node %s not found, using all CPUs\n", node);
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    for (auto c = 0u; c < std::max(1u, std::thread::hardware_concurrency()); ++c) {
+      cpus.push_back(static_cast<int>(c));
+    }
+  }
+  return cpus;
+}
+
+void pin_to(int const cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  sched_setaffinity(0, sizeof(set), &set);
+#else
+  static_cast<void>(cpu);
+#endif
+}
+
+struct scaling_config {
+  std::vector<int> cpus;
+  bool             pin;
+  std::size_t      bytes_per_thread;
+};
+
+enum class kernel { parse, format };
+
+struct scaling_point {
+  unsigned      threads;
+  double        bytes_per_second;
+  std::uint64_t checksum;
+};
+
+// threads 個のスレッドで、それぞれ自分のバッファを MIN_MEASURE_TIME の間くり返し処理する
+auto run(kernel const k, unsigned const threads, scaling_config const& config) -> scaling_point {
+  using clock = std::chrono::steady_clock;
+
+  auto ready   = std::barrier{static_cast<std::ptrdiff_t>(threads) + 1};
+  auto done    = std::barrier{static_cast<std::ptrdiff_t>(threads) + 1};
+  auto stop    = std::atomic<bool>{false};
+  auto sink    = std::atomic<std::uint64_t>{0};
+  auto bytes   = std::vector<std::uint64_t>(threads);
+  auto workers = std::vector<std::jthread>{};
+
+  for (auto t = 0u; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      if (config.pin) {
+        pin_to(config.cpus[t % config.cpus.size()]);
+      }
+      // 確保と初期化をこのスレッドで行い、ファーストタッチで近いメモリに置く
+      auto const lines  = config.bytes_per_thread / LINE_LENGTH;
+      auto       text   = macad_parser::padded_string{k == kernel::parse ? lines * LINE_LENGTH : 0};
+      auto const n      = config.bytes_per_thread / (sizeof(std::uint64_t) + macad_parser::MAC_ADDRESS_STRING_LENGTH);
+      auto       values = std::vector<std::uint64_t>(k == kernel::format ? n : 0);
+      auto       out    = std::vector<char>(values.size() * macad_parser::MAC_ADDRESS_STRING_LENGTH);
+      for (auto i = std::size_t{0}; i < values.size(); ++i) {
+        values[i] = test_support::mac_value(i);
+      }
+      test_support::fill_mac_lines(std::span<char>{text.data(), text.size()});
+
+      ready.arrive_and_wait();
+      auto acc = std::uint64_t{0};
+      while (not stop.load(std::memory_order_relaxed)) {
+        if (k == kernel::parse) {
+          for (auto i = std::size_t{0}; i < lines; ++i) {
+            acc += macad_parser::parse_mac_address(text.view().substr(i * LINE_LENGTH, macad_parser::MAC_ADDRESS_STRING_LENGTH)).value_or(0);
+          }
+          bytes[t] += lines * LINE_LENGTH;
+        } else {
+          macad_parser::format_mac_addresses_to_buffer(values, out);
+          acc += static_cast<std::uint64_t>(out[out.size() / 2]);
+          bytes[t] += n * (sizeof(std::uint64_t) + macad_parser::MAC_ADDRESS_STRING_LENGTH);
+        }
+      }
+      // 結果を共有変数に残し、計算が最適化で消えないようにする
+      sink.fetch_add(acc, std::memory_order_relaxed);
+      done.arrive_and_wait();
+    });
+  }
+
+  ready.arrive_and_wait();
+  auto const t0 = clock::now();
+  std::this_thread::sleep_for(MIN_MEASURE_TIME);
+  stop.store(true, std::memory_order_relaxed);
+  done.arrive_and_wait();
+  auto const seconds = std::chrono::duration<double>(clock::now() - t0).count();
+  workers.clear();
+
+  auto total = std::uint64_t{0};
+  for (auto const b : bytes) {
+    total += b;
+  }
+  return scaling_point{threads, static_cast<double>(total) / seconds, sink.load(std::memory_order_relaxed)};
+}
+
+// 1, 2, 4, ... と最大スレッド数
+auto thread_counts(unsigned const max) -> std::vector<unsigned> {
+  auto counts = std::vector<unsigned>{};
+  for (auto n = 1u; n < max; n *= 2) {
+    counts.push_back(n);
+  }
+  counts.push_back(max);
+  return counts;
+}
+
+void report(char const* const name, std::vector<scaling_point> const& points) {
+  auto const single = points.front().bytes_per_second;
+  std::printf("\n%s\n%8s %10s %10s %12s\n", name, "threads", "GB/s", "speedup", "efficiency");
+  auto flatten = std::optional<unsigned>{};
+  for (auto i = std::size_t{0}; i < points.size(); ++i) {
+    auto const& p       = points[i];
+    auto const  speedup = p.bytes_per_second / single;
+    std::printf("%8u %10.2f %10.2f %11.0f%%\n", p.threads, p.bytes_per_second / 1e9, speedup, speedup / p.threads * 100.0);
+    // 直前の点からの伸びがしきい値を下回った最初の点を「頭打ち」とする
+    if (i > 0 and not flatten and p.bytes_per_second < points[i - 1].bytes_per_second * (1.0 + FLATTEN_THRESHOLD)) {
+      flatten = points[i - 1].threads;
+    }
+  }
+  auto const peak = std::max_element(points.begin(), points.end(), [](auto const& a, auto const& b) { return a.bytes_per_second < b.bytes_per_second; });
+  if (flatten) {
+    std::printf("scaling flattens at %u thread(s) (peak %.2f GB/s with %u thread(s))\n", *flatten, peak->bytes_per_second / 1e9, peak->threads);
+  } else {
+    std::printf("scaling does not flatten up to %u thread(s)\n", points.back().threads);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Benchmark: multi-thread scaling of batch parse and format", "[.scaling]") {
+  auto config = scaling_config{
+    .cpus             = available_cpus(),
+    .pin              = env_is_one("MACAD_BENCH_PIN") or std::getenv("MACAD_BENCH_NUMA_NODE") != nullptr,
+    .bytes_per_thread = test_support::env_size("MACAD_BENCH_BYTES", DEFAULT_BYTES),
+  };
+  auto const max_threads = static_cast<unsigned>(test_support::env_size("MACAD_BENCH_THREADS", config.cpus.size()));
+  REQUIRE(max_threads > 0);
+
+  std::printf("scaling: %zu usable CPU(s), %zu bytes per thread, pinning %s\n", config.cpus.size(), config.bytes_per_thread, config.pin ? "on" : "off");
+
+  for (auto const& [k, name] : {std::pair{kernel::parse, "parse_mac_address (padded)"}, std::pair{kernel::format, "format_mac_addresses_to_buffer"}}) {
+    auto points = std::vector<scaling_point>{};
+    for (auto const threads : thread_counts(max_threads)) {
+      points.push_back(run(k, threads, config));
+    }
+    report(name, points);
+    REQUIRE(points.front().bytes_per_second > 0.0);
+  }
+}
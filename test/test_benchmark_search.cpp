@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-search.hpp"
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// ウォッチリスト検索（search_mac_watchlist）と `grep -F -i` の比較 Benchmark
+//
+// 約64MiBのログ（1行に2つのMACアドレス、0.1%の行だけがウォッチリストに該当）から、
+// 1万件のウォッチリストに含まれるMACアドレスを含む行を探す
+// grep には各MACアドレスを ':' 区切りと '-' 区切りに展開した2万個の固定文字列パターンを渡し、
+// 大文字・小文字は -i で無視させる。grep はファイルから読むため、ページキャッシュに載った状態で比べる
+// 上限の目安として、同じテキストを8byteずつ読んで足し合わせるだけのループ（メモリ帯域）の速度も表示する
+// 時間がかかるため通常のテストでは実行しない（"[search]" を指定したときだけ実行する）
+// ============================================================================
+
+namespace {
+
+constexpr auto WATCHLIST_SIZE = std::size_t{10000};
+constexpr auto LOG_BYTES      = std::size_t{64} << 20;
+constexpr auto HIT_INTERVAL   = std::size_t{1000};
+
+struct hyphen_lower_options {
+  static constexpr char delimiter = '-';
+  static constexpr bool uppercase = false;
+};
+
+struct search_fixture {
+  std::vector<std::uint64_t> targets;
+  std::string                text;
+  std::size_t                hit_lines = 0;
+};
+
+auto make_fixture() -> search_fixture {
+  auto f = search_fixture{};
+  for (auto i = std::uint64_t{0}; i < WATCHLIST_SIZE; ++i) {
+    f.targets.push_back(test_support::mac_value(i + 1));
+  }
+  f.text.reserve(LOG_BYTES + 256);
+  for (auto i = std::uint64_t{0}; f.text.size() < LOG_BYTES; ++i) {
+    auto const src = (i % HIT_INTERVAL == 0) ? f.targets[i % WATCHLIST_SIZE] : 0x020000000000ull + i;
+    f.text += "2024-01-01T00:00:00 host42 dhcpd: DHCPACK on 10.0.0.1 to ";
+    f.text += (i % 2 == 0) ? macad_parser::format_mac_address(src) : macad_parser::format_mac_address<hyphen_lower_options>(src);
+    f.text += " via ";
+    f.text += macad_parser::format_mac_address(0x040000000000ull + i);
+    f.text += '\n';
+    f.hit_lines += (i % HIT_INTERVAL == 0) ? 1 : 0;
+  }
+  return f;
+}
+
+// テキスト全体を8byteずつ読むだけのループ（1スレッドで読めるメモリ帯域の目安）
+auto sum_words(std::string const& text) -> std::uint64_t {
+  auto sum = std::uint64_t{0};
+  for (auto i = std::size_t{0}; i + sizeof(std::uint64_t) <= text.size(); i += sizeof(std::uint64_t)) {
+    auto word = std::uint64_t{0};
+    std::memcpy(&word, text.data() + i, sizeof(word));
+    sum += word;
+  }
+  return sum;
+}
+
+auto write_file(std::filesystem::path const& path, std::string const& content) -> bool {
+  auto* const fp = std::fopen(path.string().c_str(), "wb");
+  if (fp == nullptr) {
+    return false;
+  }
+  auto const ok = std::fwrite(content.data(), 1, content.size(), fp) == content.size();
+  return std::fclose(fp) == 0 and ok;
+}
+
+}  // namespace
+
+TEST_CASE("Benchmark: watchlist search vs grep -F -i", "[.search]") {
+  auto const fixture   = make_fixture();
+  auto const watchlist = macad_parser::mac_watchlist{fixture.targets};
+  auto const mib       = static_cast<double>(fixture.text.size()) / (1 << 20);
+
+  REQUIRE(macad_parser::search_mac_watchlist(fixture.text, watchlist).size() == fixture.hit_lines);
+
+  BENCHMARK("search_mac_watchlist 64MiB, 10k targets") {
+    return macad_parser::search_mac_watchlist(fixture.text, watchlist, [](std::size_t, std::size_t, std::uint64_t) {});
+  };
+
+  using clock     = std::chrono::steady_clock;
+  auto       t0   = clock::now();
+  auto const n    = macad_parser::search_mac_watchlist(fixture.text, watchlist, [](std::size_t, std::size_t, std::uint64_t) {});
+  auto const ours = std::chrono::duration<double>(clock::now() - t0).count();
+
+  t0 = clock::now();
+  [[maybe_unused]] auto volatile sum = sum_words(fixture.text);
+  auto const bandwidth               = std::chrono::duration<double>(clock::now() - t0).count();
+  std::printf("search_mac_watchlist: %zu lines, %.1f MiB/s (%.0f%% of a plain read at %.1f MiB/s)\n", n, mib / ours, 100.0 * bandwidth / ours, mib / bandwidth);
+
+#if defined(__unix__) || defined(__APPLE__)
+  auto const dir      = std::filesystem::temp_directory_path();
+  auto const log      = dir / "macad_parser_bench_search.log";
+  auto const patterns = dir / "macad_parser_bench_search.patterns";
+  auto       expanded = std::string{};
+  for (auto const t : fixture.targets) {
+    expanded += macad_parser::format_mac_address(t) + '\n' + macad_parser::format_mac_address<hyphen_lower_options>(t) + '\n';
+  }
+  if (not write_file(log, fixture.text) or not write_file(patterns, expanded)) {
+    std::printf("grep -F -i: could not write temporary files, skipped\n");
+    return;
+  }
+
+  auto const command = "grep -F -i -c -f '" + patterns.string() + "' '" + log.string() + "'";
+  // 1回目でページキャッシュに載せ、2回目を測る
+  for (auto round = 0; round < 2; ++round) {
+    t0             = clock::now();
+    auto* const fp = ::popen(command.c_str(), "r");
+    if (fp == nullptr) {
+      std::printf("grep -F -i: could not run grep, skipped\n");
+      break;
+    }
+    auto       count = 0ull;
+    auto const read  = std::fscanf(fp, "%llu", &count);
+    ::pclose(fp);
+    auto const seconds = std::chrono::duration<double>(clock::now() - t0).count();
+    if (read != 1) {
+      std::printf("grep -F -i: no output, skipped\n");
+      break;
+    }
+    if (round == 1) {
+      CHECK(count == fixture.hit_lines);
+      std::printf("grep -F -i (%zu patterns): %llu lines, %.1f MiB/s (search_mac_watchlist is %.1fx)\n", fixture.targets.size() * 2, count, mib / seconds, seconds / ours);
+    }
+  }
+  std::filesystem::remove(log);
+  std::filesystem::remove(patterns);
+#endif
+}
@@ -0,0 +1,247 @@
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-padded.hpp"
+#include "macad-parser-table.hpp"
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// 作業領域の大きさ（キャッシュに収まるかどうか）によるスループットの変化を測るスイープ
+//
+// 4KiBから2倍ずつ大きくしながら、各カーネルのスループットを測る
+// 時間がかかるため通常のテストでは実行しない（"[sweep]" を指定して実行する）
+//
+// バッチパースとテーブル検索は、何件先をソフトウェアプリフェッチするか（先読み距離）を変えても測り、
+// サイズごとに最適な距離（と、プリフェッチが効き始めるサイズ）を比べられるようにする
+//
+//   MACAD_BENCH_SWEEP_MAX       最大サイズ（例: 4G。デフォルト 256M）
+//   MACAD_BENCH_SWEEP_CSV       結果を書き出すCSVファイル（グラフ作成用）
+//   MACAD_BENCH_SWEEP_PREFETCH  カンマ区切りの先読み距離（何件先か。例: 4,16,64。デフォルト 8,32。0 はプリフェッチなし）
+// ============================================================================
+
+namespace {
+
+using test_support::LINE_LENGTH;
+
+constexpr auto SWEEP_MIN         = std::size_t{4} << 10;
+constexpr auto SWEEP_DEFAULT_MAX = std::size_t{256} << 20;
+constexpr auto SWEEP_LIMIT       = std::size_t{4} << 30;
+constexpr auto MIN_MEASURE_TIME  = std::chrono::milliseconds{100};
+constexpr auto BATCH             = std::size_t{256};
+constexpr auto CACHE_LINE        = std::size_t{64};
+
+auto sweep_max() -> std::size_t {
+  auto const max = test_support::env_size("MACAD_BENCH_SWEEP_MAX", SWEEP_DEFAULT_MAX);
+  return max < SWEEP_LIMIT ? max : SWEEP_LIMIT;
+}
+
+// "4,16,64" を読む（読めない要素は無視する）
+auto prefetch_distances() -> std::vector<std::size_t> {
+  auto const* const env  = std::getenv("MACAD_BENCH_SWEEP_PREFETCH");
+  auto              list = std::string_view{env != nullptr ? env : "8,32"};
+  auto              out  = std::vector<std::size_t>{};
+  while (not list.empty()) {
+    auto const comma = list.find(',');
+    auto const item  = list.substr(0, comma);
+    auto       value = std::size_t{0};
+    if (std::from_chars(item.data(), item.data() + item.size(), value).ec == std::errc{} and value > 0) {
+      out.push_back(value);
+    }
+    list = (comma == std::string_view::npos) ? std::string_view{} : list.substr(comma + 1);
+  }
+  return out;
+}
+
+struct sweep_point {
+  std::string kernel;
+  std::size_t prefetch_distance;
+  std::size_t working_set;
+  double      bytes_per_second;
+  double      items_per_second;
+};
+
+// 1回目はウォームアップとして除き、合計が MIN_MEASURE_TIME を超えるまで繰り返して平均を取る
+auto measure(std::string kernel, std::size_t const prefetch_distance, std::size_t const working_set, std::size_t const bytes, std::size_t const items,
+             std::function<std::uint64_t()> const& pass) -> sweep_point {
+  using clock    = std::chrono::steady_clock;
+  auto sink      = pass();
+  auto passes    = std::size_t{0};
+  auto const t0  = clock::now();
+  auto       now = t0;
+  do {
+    sink += pass();
+    ++passes;
+    now = clock::now();
+  } while (now - t0 < MIN_MEASURE_TIME);
+  static_cast<void>(sink);
+
+  auto const seconds = std::chrono::duration<double>(now - t0).count();
+  return sweep_point{
+    .kernel            = std::move(kernel),
+    .prefetch_distance = prefetch_distance,
+    .working_set       = working_set,
+    .bytes_per_second  = static_cast<double>(bytes * passes) / seconds,
+    .items_per_second  = static_cast<double>(items * passes) / seconds,
+  };
+}
+
+// 各サイズについて、テキスト入力のパース系カーネルを測る
+void sweep_text(std::size_t const size, std::span<std::size_t const> const distances, std::vector<sweep_point>& out) {
+  auto const text  = test_support::make_mac_lines(size);
+  auto const lines = size / LINE_LENGTH;
+  auto const bytes = lines * LINE_LENGTH;
+
+  out.push_back(measure("parse_mac_address (padded)", 0, size, bytes, lines, [&] {
+    auto acc = std::uint64_t{0};
+    for (auto i = std::size_t{0}; i < lines; ++i) {
+      acc += macad_parser::parse_mac_address(text.view().substr(i * LINE_LENGTH, macad_parser::MAC_ADDRESS_STRING_LENGTH)).value_or(0);
+    }
+    return acc;
+  }));
+
+  // distance 行先までのテキストを、バッチごとにキャッシュライン単位でプリフェッチする（0 はプリフェッチなし）
+  auto const batch_parse = [&](std::size_t const distance) {
+    return [&, distance] {
+      auto views   = std::array<std::string_view, BATCH>{};
+      auto results = std::array<std::optional<std::uint64_t>, BATCH>{};
+      auto acc     = std::uint64_t{0};
+      for (auto first = std::size_t{0}; first < lines; first += BATCH) {
+        auto const n = (lines - first < BATCH) ? lines - first : BATCH;
+        if (distance > 0) {
+          auto const begin = (first + distance) * LINE_LENGTH;
+          auto const end   = std::min((first + distance + n) * LINE_LENGTH, bytes);
+          for (auto offset = begin; offset < end; offset += CACHE_LINE) {
+            simde_mm_prefetch(text.data() + offset, SIMDE_MM_HINT_T0);
+          }
+        }
+        for (auto i = std::size_t{0}; i < n; ++i) {
+          views[i] = std::string_view{text.data() + (first + i) * LINE_LENGTH, macad_parser::MAC_ADDRESS_STRING_LENGTH};
+        }
+        acc += macad_parser::parse_mac_addresses(std::span{views.data(), n}, std::span{results.data(), n});
+      }
+      return acc;
+    };
+  };
+  out.push_back(measure("parse_mac_addresses (batch 256)", 0, size, bytes, lines, batch_parse(0)));
+  for (auto const distance : distances) {
+    out.push_back(measure("parse_mac_addresses (batch 256)", distance, size, bytes, lines, batch_parse(distance)));
+  }
+
+  out.push_back(measure("scan_mac_addresses", 0, size, bytes, lines, [&] {
+    auto acc = std::uint64_t{0};
+    macad_parser::scan_mac_addresses(text.view(), [&](std::size_t, std::uint64_t const v) { acc += v; });
+    return acc;
+  }));
+}
+
+// 値の配列（8byte）と出力先（17byte）を合わせて size バイトになるように並べて整形する
+void sweep_format(std::size_t const size, std::vector<sweep_point>& out) {
+  auto const n      = size / (sizeof(std::uint64_t) + macad_parser::MAC_ADDRESS_STRING_LENGTH);
+  auto const values = test_support::mac_values(n);
+  auto buffer = std::vector<char>(n * macad_parser::MAC_ADDRESS_STRING_LENGTH);
+
+  out.push_back(measure("format_mac_addresses_to_buffer", 0, size, n * (sizeof(std::uint64_t) + macad_parser::MAC_ADDRESS_STRING_LENGTH), n, [&] {
+    macad_parser::format_mac_addresses_to_buffer(values, buffer);
+    return static_cast<std::uint64_t>(buffer[buffer.size() / 2]);
+  }));
+}
+
+// テーブル本体が size バイトになる容量で、半分まで埋めたテーブルをランダムに検索する
+// スループットの換算では、検索1回あたり1スロット（16byte）を読むとみなす
+// プリフェッチありの計測では、同じ乱数列を distance 回先に進めた系列で、先に検索するキーのスロットを読み込み始める
+void sweep_lookup(std::size_t const size, std::span<std::size_t const> const distances, std::vector<sweep_point>& out) {
+  constexpr auto SLOT_BYTES = std::size_t{16};
+  constexpr auto LOOKUPS    = std::size_t{1} << 16;
+
+  auto const capacity = std::bit_floor(size / SLOT_BYTES);
+  auto const keys     = capacity / 2;
+  auto       table    = macad_parser::concurrent_mac_table<>{capacity};
+  for (auto i = std::uint64_t{0}; i < keys; ++i) {
+    table.upsert(macad_parser::detail::mix_mac_address(i) & 0xFFFFFFFFFFFFull, i);
+  }
+
+  auto const next_key = [keys](std::uint64_t& seed) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return macad_parser::detail::mix_mac_address((seed >> 16) % keys) & 0xFFFFFFFFFFFFull;
+  };
+
+  out.push_back(measure("concurrent_mac_table::find", 0, size, LOOKUPS * SLOT_BYTES, LOOKUPS, [&, seed = std::uint64_t{0}]() mutable {
+    auto acc = std::uint64_t{0};
+    for (auto i = std::size_t{0}; i < LOOKUPS; ++i) {
+      acc += table.find(next_key(seed)).value_or(0);
+    }
+    return acc;
+  }));
+
+  for (auto const distance : distances) {
+    out.push_back(measure("concurrent_mac_table::find", distance, size, LOOKUPS * SLOT_BYTES, LOOKUPS, [&, distance, seed = std::uint64_t{0}]() mutable {
+      auto ahead = seed;
+      for (auto i = std::size_t{0}; i < distance; ++i) {
+        table.prefetch_hashed(macad_parser::detail::mix_mac_address(next_key(ahead)));
+      }
+      auto acc = std::uint64_t{0};
+      for (auto i = std::size_t{0}; i < LOOKUPS; ++i) {
+        table.prefetch_hashed(macad_parser::detail::mix_mac_address(next_key(ahead)));
+        acc += table.find(next_key(seed)).value_or(0);
+      }
+      return acc;
+    }));
+  }
+}
+
+void write_csv(char const* const path, std::vector<sweep_point> const& points) {
+  auto* const fp = std::fopen(path, "w");
+  if (fp == nullptr) {
+    std::perror(path);
+    return;
+  }
+  std::fputs("kernel,prefetch_distance,working_set_bytes,bytes_per_second,items_per_second,ns_per_item\n", fp);
+  for (auto const& p : points) {
+    std::fprintf(fp, "%s,%zu,%zu,%.6g,%.6g,%.6g\n", p.kernel.c_str(), p.prefetch_distance, p.working_set, p.bytes_per_second, p.items_per_second, 1e9 / p.items_per_second);
+  }
+  std::fclose(fp);
+}
+
+}  // namespace
+
+TEST_CASE("Benchmark: cache-residency sweep", "[.sweep]") {
+  auto const max       = sweep_max();
+  auto const distances = prefetch_distances();
+  auto       points    = std::vector<sweep_point>{};
+
+  for (auto size = SWEEP_MIN; size <= max; size *= 2) {
+    try {
+      sweep_text(size, distances, points);
+      sweep_format(size, points);
+      sweep_lookup(size, distances, points);
+    } catch (std::bad_alloc const&) {
+      std::fprintf(stderr, "sweep: stopped at %zu bytes (out of memory)\n", size);
+      break;
+    }
+  }
+
+  std::printf("%-34s %8s %14s %10s %12s %10s\n", "kernel", "prefetch", "working set", "GB/s", "Mitems/s", "ns/item");
+  for (auto const& p : points) {
+    std::printf("%-34s %8zu %14zu %10.2f %12.1f %10.2f\n", p.kernel.c_str(), p.prefetch_distance, p.working_set, p.bytes_per_second / 1e9, p.items_per_second / 1e6, 1e9 / p.items_per_second);
+  }
+  if (auto const* const csv = std::getenv("MACAD_BENCH_SWEEP_CSV")) {
+    write_csv(csv, points);
+  }
+  REQUIRE_FALSE(points.empty());
+}
@@ -0,0 +1,146 @@
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-table.hpp"
+#include "test_support.hpp"
+
+// ============================================================================
+// 並行ハッシュテーブルのスケーリング Benchmarks
+// ============================================================================
+
+namespace {
+
+// 1スレッドあたりの操作数と、全スレッドで共有するキーの種類
+constexpr auto OPS_PER_THREAD = std::uint64_t{1} << 14;
+constexpr auto DISTINCT_KEYS  = std::uint64_t{1} << 16;
+
+// スレッドごとに異なる順序でキーを巡回する（共有キーへの書き込みが競合するように）
+[[nodiscard]]
+auto key_for(unsigned const thread, std::uint64_t const i) noexcept -> std::uint64_t {
+  return 0x020000000000ull | ((i * 0x9E3779B1ull + thread * 0x632BE5ABull) & (DISTINCT_KEYS - 1));
+}
+
+// 書き込み1回に対して読み込みを3回行う、学習テーブルらしい負荷
+template <typename Upsert, typename Find>
+auto run_threads(unsigned const threads, Upsert upsert, Find find) -> std::uint64_t {
+  auto sums    = std::vector<std::uint64_t>(threads);
+  auto workers = std::vector<std::jthread>{};
+  for (auto t = 0u; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      auto sum = std::uint64_t{0};
+      for (auto i = std::uint64_t{0}; i < OPS_PER_THREAD; ++i) {
+        auto const key = key_for(t, i);
+        if ((i & 3) == 0) {
+          upsert(key, i);
+        } else {
+          sum += find(key);
+        }
+      }
+      sums[t] = sum;
+    });
+  }
+  workers.clear();
+
+  auto total = std::uint64_t{0};
+  for (auto const s : sums) {
+    total += s;
+  }
+  return total;
+}
+
+}  // namespace
+
+TEST_CASE("Benchmark: concurrent_mac_table scaling", "[benchmark]") {
+  for (auto const threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+    auto table = macad_parser::concurrent_mac_table<>{DISTINCT_KEYS * 2};
+
+    BENCHMARK("concurrent_mac_table upsert/find " + std::to_string(threads) + " threads") {
+      return run_threads(
+        threads, [&](std::uint64_t const key, std::uint64_t const v) { table.upsert(key, v); },
+        [&](std::uint64_t const key) { return table.find(key).value_or(0); });
+    };
+  }
+}
+
+TEST_CASE("Benchmark: mutex + unordered_map scaling - baseline", "[benchmark]") {
+  for (auto const threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+    auto mutex = std::mutex{};
+    auto map   = std::unordered_map<std::uint64_t, std::uint64_t>{};
+    map.reserve(DISTINCT_KEYS);
+
+    BENCHMARK("mutex + unordered_map upsert/find " + std::to_string(threads) + " threads") {
+      return run_threads(
+        threads,
+        [&](std::uint64_t const key, std::uint64_t const v) {
+          auto const lock = std::scoped_lock{mutex};
+          map[key]        = v;
+        },
+        [&](std::uint64_t const key) {
+          auto const lock = std::scoped_lock{mutex};
+          auto const it   = map.find(key);
+          return it == map.end() ? std::uint64_t{0} : it->second;
+        });
+    };
+  }
+}
+
+TEST_CASE("Benchmark: ingest MAC address strings into concurrent_mac_table", "[benchmark]") {
+  // LLCに収まらない大きさのテーブルに、ランダムな位置へ挿入する
+  constexpr auto count = std::size_t{1} << 16;
+  auto           texts = std::vector<std::string>{};
+  for (auto i = std::size_t{0}; i < count; ++i) {
+    texts.push_back(macad_parser::format_mac_address(test_support::mac_value(i)));
+  }
+  auto const views  = std::vector<std::string_view>(texts.begin(), texts.end());
+  auto const values = std::vector<std::uint64_t>(count, 1);
+  auto       table  = macad_parser::concurrent_mac_table<>{std::size_t{1} << 22};
+
+  BENCHMARK("parse_mac_address + upsert x65536") {
+    auto written = std::size_t{0};
+    for (auto i = std::size_t{0}; i < count; ++i) {
+      if (auto const mac = macad_parser::parse_mac_address(views[i])) {
+        written += table.upsert(*mac, values[i]) ? 1 : 0;
+      }
+    }
+    return written;
+  };
+  BENCHMARK("upsert_mac_addresses (fused parse+hash, prefetch) x65536") {
+    return table.upsert_mac_addresses(views, values);
+  };
+}
+
+TEST_CASE("Benchmark: hash step of parse_and_hash_mac_addresses", "[benchmark]") {
+  // パースだけ・パースとハッシュ・ハッシュだけを比べ、ハッシュが占める割合を確かめる
+  constexpr auto count  = std::size_t{256};
+  auto           texts  = std::vector<std::string>{};
+  auto           values = std::vector<std::uint64_t>(count);
+  for (auto i = std::size_t{0}; i < count; ++i) {
+    values[i] = test_support::mac_value(i);
+    texts.push_back(macad_parser::format_mac_address(values[i]));
+  }
+  auto const views  = std::vector<std::string_view>(texts.begin(), texts.end());
+  auto       out    = std::vector<std::optional<std::uint64_t>>(count);
+  auto       hashes = std::vector<std::uint64_t>(count);
+
+  BENCHMARK("parse_mac_addresses x256") {
+    return macad_parser::parse_mac_addresses(views, out);
+  };
+  BENCHMARK("parse_and_hash_mac_addresses x256") {
+    return macad_parser::parse_and_hash_mac_addresses(views, out, hashes);
+  };
+  BENCHMARK("mix_mac_address x256 (hash step only)") {
+    for (auto i = std::size_t{0}; i < count; ++i) {
+      hashes[i] = macad_parser::detail::mix_mac_address(values[i]);
+    }
+    return hashes[count / 2];
+  };
+}
@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-views.hpp"
+
+// ============================================================================
+// Rangesアダプタ Benchmarks（ブロック処理 vs 要素ごとの transform）
+// ============================================================================
+
+TEST_CASE("Benchmark: views::parse vs views::transform", "[benchmark]") {
+  auto texts = std::vector<std::string>{};
+  for (auto i = std::uint64_t{0}; i < 4096; ++i) {
+    texts.push_back(macad_parser::format_mac_address(i * 0x0000010203040506ull));
+  }
+  auto const views = std::vector<std::string_view>(texts.begin(), texts.end());
+
+  BENCHMARK("transform(parse_mac_address) 4096") {
+    auto sum = std::uint64_t{0};
+    for (auto const v : views | std::views::transform([](std::string_view const s) { return macad_parser::parse_mac_address(s); })) {
+      sum += v.value_or(0);
+    }
+    return sum;
+  };
+
+  BENCHMARK("views::parse 4096") {
+    auto sum = std::uint64_t{0};
+    for (auto const v : views | macad_parser::views::parse) {
+      sum += v.value_or(0);
+    }
+    return sum;
+  };
+}
+
+TEST_CASE("Benchmark: views::format vs views::transform", "[benchmark]") {
+  auto values = std::vector<std::uint64_t>(4096);
+  for (auto i = std::size_t{0}; i < values.size(); ++i) {
+    values[i] = i * 0x0000010203040506ull;
+  }
+
+  BENCHMARK("transform(format_mac_address) 4096") {
+    auto sum = std::size_t{0};
+    for (auto const& s : values | std::views::transform([](std::uint64_t const v) { return macad_parser::format_mac_address(v); })) {
+      sum += static_cast<unsigned char>(s[16]);
+    }
+    return sum;
+  };
+
+  BENCHMARK("views::format 4096") {
+    auto sum = std::size_t{0};
+    for (auto const s : values | macad_parser::views::format) {
+      sum += static_cast<unsigned char>(s[16]);
+    }
+    return sum;
+  };
+}
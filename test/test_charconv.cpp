@@ -0,0 +1,64 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser.hpp"
+
+struct opt_charconv_dash_lower {
+  static constexpr char delimiter = '-';
+  static constexpr bool uppercase = false;
+};
+
+TEST_CASE("from_chars reports the position after the mac address") {
+  SECTION("short input (safe path)") {
+    auto const text  = std::string_view{"AA:BB:CC:DD:EE:FF,1"};
+    auto       value = std::uint64_t{0};
+    auto const [ptr, ec] = macad_parser::from_chars(text.data(), text.data() + text.size(), value);
+    REQUIRE(ec == std::errc{});
+    REQUIRE(value == 0xAABBCCDDEEFFull);
+    REQUIRE(ptr == text.data() + 17);
+    REQUIRE(*ptr == ',');
+  }
+
+  SECTION("long input (unsafe path)") {
+    auto const text  = std::string_view{"01:23:45:67:89:AB 02:00:00:00:00:01 rest of the line"};
+    auto       value = std::uint64_t{0};
+    auto       res   = macad_parser::from_chars(text.data(), text.data() + text.size(), value);
+    REQUIRE(res.ec == std::errc{});
+    REQUIRE(value == 0x0123456789ABull);
+
+    res = macad_parser::from_chars(res.ptr + 1, text.data() + text.size(), value);
+    REQUIRE(res.ec == std::errc{});
+    REQUIRE(value == 0x020000000001ull);
+    REQUIRE(std::string_view{res.ptr, 5} == " rest");
+  }
+
+  SECTION("failure leaves value and position untouched") {
+    auto const text  = std::string_view{"AA:BB:CC:DD:EE:GG and some padding"};
+    auto       value = std::uint64_t{42};
+    auto const res   = macad_parser::from_chars(text.data(), text.data() + text.size(), value, macad_parser::parse_mac_options_strict{});
+    REQUIRE(res.ec == std::errc::invalid_argument);
+    REQUIRE(res.ptr == text.data());
+    REQUIRE(value == 42);
+
+    auto const shorter = std::string_view{"AA:BB:CC"};
+    REQUIRE(macad_parser::from_chars(shorter.data(), shorter.data() + shorter.size(), value).ec == std::errc::invalid_argument);
+  }
+}
+
+TEST_CASE("to_chars writes 17 characters and reports the end") {
+  auto buffer = std::array<char, 20>{};
+
+  auto const [ptr, ec] = macad_parser::to_chars<opt_charconv_dash_lower>(buffer.data(), buffer.data() + buffer.size(), 0xAABBCCDDEEFFull);
+  REQUIRE(ec == std::errc{});
+  REQUIRE(ptr == buffer.data() + 17);
+  REQUIRE(std::string_view{buffer.data(), 17} == "aa-bb-cc-dd-ee-ff");
+
+  auto const res = macad_parser::to_chars(buffer.data(), buffer.data() + 16, 0xAABBCCDDEEFFull);
+  REQUIRE(res.ec == std::errc::value_too_large);
+  REQUIRE(res.ptr == buffer.data() + 16);
+}
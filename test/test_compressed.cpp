@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-compressed.hpp"
+
+namespace {
+
+auto make_log(std::size_t const lines) -> std::string {
+  auto text = std::string{};
+  for (auto i = std::uint64_t{1}; i <= lines; ++i) {
+    text += "lease " + std::to_string(i) + " hw=" + macad_parser::format_mac_address(i * 0x000100010001ull) + '\n';
+  }
+  return text;
+}
+
+auto scan_all(std::string const& text) -> std::vector<std::pair<std::size_t, std::uint64_t>> {
+  auto found = std::vector<std::pair<std::size_t, std::uint64_t>>{};
+  macad_parser::scan_mac_addresses(text, [&](std::size_t const offset, std::uint64_t const v) { found.emplace_back(offset, v); });
+  return found;
+}
+
+// 読み込みのたびに最大 step バイトを返すソース
+auto memory_source(std::string const& data, std::size_t const step) {
+  return [&data, step, pos = std::size_t{0}](std::span<char> const buffer) mutable {
+    auto const n = std::min({buffer.size(), step, data.size() - pos});
+    std::memcpy(buffer.data(), data.data() + pos, n);
+    pos += n;
+    return n;
+  };
+}
+
+auto small_buffers() -> macad_parser::compressed_scan_config {
+  auto config        = macad_parser::compressed_scan_config{};
+  config.buffer_size = 1000;
+  config.buffers     = 2;
+  config.input_size  = 300;
+  return config;
+}
+
+#if MACAD_PARSER_HAS_ZLIB
+// gzip形式で圧縮する
+auto gzip(std::string const& text) -> std::string {
+  auto stream = z_stream{};
+  REQUIRE(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+  auto out          = std::string(deflateBound(&stream, static_cast<uLong>(text.size())) + 32, '\0');
+  stream.next_in    = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+  stream.avail_in   = static_cast<uInt>(text.size());
+  stream.next_out   = reinterpret_cast<Bytef*>(out.data());
+  stream.avail_out  = static_cast<uInt>(out.size());
+  REQUIRE(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  return out;
+}
+#endif
+
+#if MACAD_PARSER_HAS_ZSTD
+// チェックサム付きのzstdフレーム1つに圧縮する
+auto zstd(std::string const& text) -> std::string {
+  auto* const context = ZSTD_createCCtx();
+  REQUIRE(context != nullptr);
+  ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+  auto       out  = std::string(ZSTD_compressBound(text.size()), '\0');
+  auto const size = ZSTD_compress2(context, out.data(), out.size(), text.data(), text.size());
+  ZSTD_freeCCtx(context);
+  REQUIRE_FALSE(ZSTD_isError(size));
+  out.resize(size);
+  return out;
+}
+#endif
+
+}  // namespace
+
+TEST_CASE("detect_compression reads magic numbers") {
+  REQUIRE(macad_parser::detect_compression(std::span<char const>{"\x1f\x8b\x08\x00", 4}) == macad_parser::compression_format::gzip);
+  REQUIRE(macad_parser::detect_compression(std::span<char const>{"\x28\xb5\x2f\xfd", 4}) == macad_parser::compression_format::zstd);
+  REQUIRE(macad_parser::detect_compression(std::span<char const>{"AA:B", 4}) == macad_parser::compression_format::none);
+  REQUIRE(macad_parser::detect_compression(std::span<char const>{"\x28\xb5", 2}) == macad_parser::compression_format::none);
+  REQUIRE(macad_parser::is_compression_supported(macad_parser::compression_format::none));
+}
+
+TEST_CASE("scan_compressed_mac_addresses passes uncompressed input through") {
+  auto const text     = make_log(300);
+  auto const expected = scan_all(text);
+
+  auto found         = std::vector<std::pair<std::size_t, std::uint64_t>>{};
+  auto const metrics = macad_parser::scan_compressed_mac_addresses(memory_source(text, 77), [&](std::size_t const offset, std::uint64_t const v) { found.emplace_back(offset, v); }, small_buffers());
+
+  REQUIRE(metrics.ok);
+  REQUIRE(metrics.format == macad_parser::compression_format::none);
+  REQUIRE(found == expected);
+  REQUIRE(metrics.macs == expected.size());
+  REQUIRE(metrics.compressed_bytes == text.size());
+  REQUIRE(metrics.decompress.bytes == text.size());
+  REQUIRE(metrics.parse.bytes == text.size());
+
+  auto const empty = std::string{};
+  REQUIRE(macad_parser::scan_compressed_mac_addresses(memory_source(empty, 1), [](std::size_t, std::uint64_t) {}).macs == 0);
+}
+
+TEST_CASE("exceptions from either stage propagate to the caller") {
+  auto const text = make_log(300);
+  REQUIRE_THROWS_AS(macad_parser::scan_compressed_mac_addresses(memory_source(text, 77), [](std::size_t, std::uint64_t) { throw std::runtime_error{"stop"}; }, small_buffers()),
+                    std::runtime_error);
+
+  auto const failing = [](std::span<char>) -> std::size_t { throw std::runtime_error{"read error"}; };
+  REQUIRE_THROWS_AS(macad_parser::scan_compressed_mac_addresses(failing, [](std::size_t, std::uint64_t) {}), std::runtime_error);
+}
+
+#if MACAD_PARSER_HAS_ZLIB
+TEST_CASE("scan_compressed_mac_addresses decompresses gzip while parsing") {
+  auto const text     = make_log(2000);
+  auto const expected = scan_all(text);
+  // 連結された2つのメンバ（gzip -c a b > c と同じ形）
+  auto const compressed = gzip(text.substr(0, 12345)) + gzip(text.substr(12345));
+
+  for (auto const step : {std::size_t{1}, std::size_t{100}, compressed.size()}) {
+    auto found         = std::vector<std::pair<std::size_t, std::uint64_t>>{};
+    auto const metrics = macad_parser::scan_compressed_mac_addresses(memory_source(compressed, step), [&](std::size_t const offset, std::uint64_t const v) { found.emplace_back(offset, v); }, small_buffers());
+    REQUIRE(metrics.ok);
+    REQUIRE(metrics.format == macad_parser::compression_format::gzip);
+    REQUIRE(found == expected);
+    REQUIRE(metrics.compressed_bytes == compressed.size());
+    REQUIRE(metrics.decompress.bytes == text.size());
+    REQUIRE(metrics.decompress.items == metrics.parse.items);
+  }
+
+  SECTION("truncated input is reported") {
+    auto const truncated = compressed.substr(0, compressed.size() - 10);
+    REQUIRE_FALSE(macad_parser::scan_compressed_mac_addresses(memory_source(truncated, 100), [](std::size_t, std::uint64_t) {}, small_buffers()).ok);
+  }
+
+  SECTION("corrupted input is reported") {
+    auto corrupted = compressed;
+    std::fill(corrupted.begin() + 20, corrupted.begin() + 60, '\xAA');
+    REQUIRE_FALSE(macad_parser::scan_compressed_mac_addresses(memory_source(corrupted, 100), [](std::size_t, std::uint64_t) {}, small_buffers()).ok);
+  }
+}
+#endif
+
+#if MACAD_PARSER_HAS_ZSTD
+TEST_CASE("scan_compressed_mac_addresses decompresses zstd while parsing") {
+  // フレームの終わりが展開先のバッファ（1000byte）の終わりにちょうど重なるように区切る
+  auto const text     = make_log(2000).substr(0, 30000);
+  auto const expected = scan_all(text);
+  // 連結された3つのフレーム（zstd -c a b c > d と同じ形）
+  auto const compressed = zstd(text.substr(0, 1000)) + zstd(text.substr(1000, 14000)) + zstd(text.substr(15000));
+
+  for (auto const step : {std::size_t{1}, std::size_t{100}, compressed.size()}) {
+    auto found         = std::vector<std::pair<std::size_t, std::uint64_t>>{};
+    auto const metrics = macad_parser::scan_compressed_mac_addresses(memory_source(compressed, step), [&](std::size_t const offset, std::uint64_t const v) { found.emplace_back(offset, v); }, small_buffers());
+    REQUIRE(metrics.ok);
+    REQUIRE(metrics.format == macad_parser::compression_format::zstd);
+    REQUIRE(found == expected);
+    REQUIRE(metrics.compressed_bytes == compressed.size());
+    REQUIRE(metrics.decompress.bytes == text.size());
+    REQUIRE(metrics.decompress.items == metrics.parse.items);
+  }
+
+  SECTION("truncated input is reported") {
+    for (auto const cut : {std::size_t{1}, std::size_t{4}, std::size_t{10}}) {
+      auto const truncated = compressed.substr(0, compressed.size() - cut);
+      REQUIRE_FALSE(macad_parser::scan_compressed_mac_addresses(memory_source(truncated, 100), [](std::size_t, std::uint64_t) {}, small_buffers()).ok);
+    }
+  }
+
+  SECTION("corrupted input is reported") {
+    auto corrupted = compressed;
+    std::fill(corrupted.begin() + 20, corrupted.begin() + 60, '\xAA');
+    REQUIRE_FALSE(macad_parser::scan_compressed_mac_addresses(memory_source(corrupted, 100), [](std::size_t, std::uint64_t) {}, small_buffers()).ok);
+  }
+}
+#endif
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-index.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+auto temp_path(std::string_view const name) -> std::string {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// 上位16bitにごみを持ち、重複を含む値の並び
+auto make_macs(std::size_t const n) -> std::vector<std::uint64_t> {
+  auto macs = std::vector<std::uint64_t>{};
+  for (auto i = std::uint64_t{0}; i < n; ++i) {
+    auto const mac = test_support::mac_value(i + 1);
+    macs.push_back(mac | (i << 48));
+    if (i % 10 == 0) {
+      macs.push_back(mac);
+    }
+  }
+  // 分布の偏り（同じOUIの連番）と両端の値
+  for (auto i = std::uint64_t{0}; i < 3000; ++i) {
+    macs.push_back(0x001A2B000000ull + i);
+  }
+  macs.push_back(0);
+  macs.push_back(0xFFFFFFFFFFFFull);
+  return macs;
+}
+
+auto sorted_unique(std::vector<std::uint64_t> macs) -> std::vector<std::uint64_t> {
+  for (auto& mac : macs) {
+    mac &= 0xFFFFFFFFFFFFull;
+  }
+  std::sort(macs.begin(), macs.end());
+  macs.erase(std::unique(macs.begin(), macs.end()), macs.end());
+  return macs;
+}
+
+void corrupt(std::string const& path, long const offset) {
+  auto* const fp = std::fopen(path.c_str(), "r+b");
+  REQUIRE(fp != nullptr);
+  std::fseek(fp, offset, offset < 0 ? SEEK_END : SEEK_SET);
+  auto const c = std::fgetc(fp);
+  std::fseek(fp, offset, offset < 0 ? SEEK_END : SEEK_SET);
+  std::fputc(c ^ 0x01, fp);
+  std::fclose(fp);
+}
+
+}  // namespace
+
+TEST_CASE("mapped_mac_index finds exactly the written values") {
+  auto const macs     = make_macs(100000);
+  auto const expected = sorted_unique(macs);
+  auto const path     = temp_path("macad_parser_test.macidx");
+  REQUIRE(macad_parser::write_mac_index(path, macs));
+
+  auto const index = macad_parser::mapped_mac_index::open(path);
+  REQUIRE(index.has_value());
+  REQUIRE(index->size() == expected.size());
+  REQUIRE(index->verify());
+  for (auto i = std::size_t{0}; i < expected.size(); ++i) {
+    REQUIRE((*index)[i] == expected[i]);
+  }
+  for (auto const mac : macs) {
+    REQUIRE(index->contains(mac));
+  }
+
+  // 含まれない値は std::lower_bound と同じ位置を返す
+  for (auto i = std::uint64_t{0}; i < 100000; ++i) {
+    auto const probe = (i * 0x0000123456789ABBull + 7) & 0xFFFFFFFFFFFFull;
+    auto const at    = static_cast<std::size_t>(std::lower_bound(expected.begin(), expected.end(), probe) - expected.begin());
+    REQUIRE(index->lower_bound(probe) == at);
+    REQUIRE(index->contains(probe) == std::binary_search(expected.begin(), expected.end(), probe));
+  }
+  REQUIRE(index->lower_bound(0x001A2B000000ull + 1500) == static_cast<std::size_t>(std::lower_bound(expected.begin(), expected.end(), 0x001A2B000000ull + 1500) - expected.begin()));
+
+  // ムーブしても同じ領域を指す
+  auto moved = std::move(*macad_parser::mapped_mac_index::open(path));
+  REQUIRE(moved.contains(expected[12345]));
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("write_mac_index sorts a moved vector in place") {
+  auto const macs  = make_macs(20000);
+  auto const path  = temp_path("macad_parser_test_moved.macidx");
+  auto const bytes = [&] {
+    auto* const fp   = std::fopen(path.c_str(), "rb");
+    auto        data = std::string{};
+    for (auto c = std::fgetc(fp); c != EOF; c = std::fgetc(fp)) {
+      data.push_back(static_cast<char>(c));
+    }
+    std::fclose(fp);
+    return data;
+  };
+
+  REQUIRE(macad_parser::write_mac_index(path, macs));
+  auto const copied = bytes();
+
+  auto owned = macs;
+  REQUIRE(macad_parser::write_mac_index(path, std::move(owned)));
+  REQUIRE(bytes() == copied);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped_mac_index handles empty and small sets") {
+  auto const path = temp_path("macad_parser_test_small.macidx");
+
+  REQUIRE(macad_parser::write_mac_index(path, {}));
+  auto const empty = macad_parser::mapped_mac_index::open(path);
+  REQUIRE(empty.has_value());
+  REQUIRE(empty->empty());
+  REQUIRE_FALSE(empty->contains(0));
+  REQUIRE(empty->lower_bound(0x123456ull) == 0);
+  REQUIRE(empty->verify());
+
+  auto const one = std::vector<std::uint64_t>{0xAABBCCDDEEFFull};
+  REQUIRE(macad_parser::write_mac_index(path, one));
+  auto const single = macad_parser::mapped_mac_index::open(path);
+  REQUIRE(single.has_value());
+  REQUIRE(single->size() == 1);
+  REQUIRE(single->contains(0xAABBCCDDEEFFull));
+  REQUIRE_FALSE(single->contains(0xAABBCCDDEEFEull));
+  REQUIRE(single->lower_bound(0xFFFFFFFFFFFFull) == 1);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped_mac_index rejects broken files") {
+  auto const macs = make_macs(5000);
+  auto const path = temp_path("macad_parser_test_broken.macidx");
+
+  REQUIRE_FALSE(macad_parser::mapped_mac_index::open(path).has_value());
+
+  // ヘッダ（件数）が壊れている
+  REQUIRE(macad_parser::write_mac_index(path, macs));
+  corrupt(path, 16);
+  REQUIRE_FALSE(macad_parser::mapped_mac_index::open(path).has_value());
+
+  // 基数表が壊れている
+  REQUIRE(macad_parser::write_mac_index(path, macs));
+  corrupt(path, 128);
+  REQUIRE_FALSE(macad_parser::mapped_mac_index::open(path).has_value());
+
+  // 値の領域が壊れている場合は開けるが、verify で検出できる
+  REQUIRE(macad_parser::write_mac_index(path, macs));
+  corrupt(path, -5);
+  auto const index = macad_parser::mapped_mac_index::open(path);
+  REQUIRE(index.has_value());
+  REQUIRE_FALSE(index->verify());
+
+  // 切り詰められている
+  REQUIRE(macad_parser::write_mac_index(path, macs));
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  REQUIRE_FALSE(macad_parser::mapped_mac_index::open(path).has_value());
+
+  // 別の形式のファイル
+  {
+    auto* const fp = std::fopen(path.c_str(), "wb");
+    REQUIRE(fp != nullptr);
+    std::fputs("AA:BB:CC:DD:EE:FF\n", fp);
+    std::fclose(fp);
+  }
+  REQUIRE_FALSE(macad_parser::mapped_mac_index::open(path).has_value());
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <string_view>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-intern.hpp"
+
+struct opt_intern_lower {
+  static constexpr bool uppercase = false;
+};
+
+TEST_CASE("mac string intern cache") {
+  auto cache = macad_parser::mac_string_intern<opt_intern_lower, 64>{};
+  REQUIRE(cache.memory_footprint == 64 * 32);
+
+  SECTION("formats on miss and reuses on hit") {
+    auto const a = cache(0xAABBCCDDEEFFull);
+    REQUIRE(a == "aa:bb:cc:dd:ee:ff");
+    auto const b = cache(0xAABBCCDDEEFFull);
+    REQUIRE(b.data() == a.data());
+    REQUIRE(cache.statistics().hits == 1);
+    REQUIRE(cache.statistics().misses == 1);
+    REQUIRE(cache.statistics().hit_rate() == 0.5);
+  }
+
+  SECTION("upper 16 bits are ignored") {
+    REQUIRE(cache(0xFFFF0123456789ABull) == "01:23:45:67:89:ab");
+    REQUIRE(cache.peek(0x0123456789ABull) == "01:23:45:67:89:ab");
+  }
+
+  SECTION("peek does not format") {
+    REQUIRE(cache.peek(0x112233445566ull).empty());
+    REQUIRE(cache.statistics().misses == 0);
+  }
+
+  SECTION("collisions evict and stay correct") {
+    for (auto i = std::uint64_t{0}; i < 1000; ++i) {
+      REQUIRE(cache(i) == macad_parser::format_mac_address<opt_intern_lower>(i));
+    }
+    REQUIRE(cache.statistics().misses == 1000);
+    REQUIRE(cache.statistics().evictions > 0);
+    REQUIRE(cache.statistics().evictions <= 1000 - 1);
+  }
+
+  SECTION("clear and reset") {
+    static_cast<void>(cache(1));
+    cache.clear();
+    cache.reset_statistics();
+    REQUIRE(cache.peek(1).empty());
+    static_cast<void>(cache(1));
+    REQUIRE(cache.statistics().misses == 1);
+    REQUIRE(cache.statistics().evictions == 0);
+  }
+}
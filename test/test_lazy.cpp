@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-lazy.hpp"
+#include "macad-parser.hpp"
+
+namespace {
+
+struct hyphen_options {
+  static constexpr bool validate_delimiters = true;
+  static constexpr bool validate_hex        = true;
+  static constexpr char delimiter           = '-';
+};
+
+// 結果の書き戻しは const でないオブジェクトに対してだけできる
+template <typename T>
+concept assignable_lazy_mac = requires(T& m) { m.assign(std::optional<std::uint64_t>{}); };
+
+static_assert(assignable_lazy_mac<macad_parser::lazy_mac<>>);
+static_assert(not assignable_lazy_mac<macad_parser::lazy_mac<> const>);
+static_assert(not std::is_invocable_v<decltype(&macad_parser::materialize_mac_addresses<>), std::span<macad_parser::lazy_mac<> const>, std::span<std::size_t const>>);
+
+}  // namespace
+
+TEST_CASE("mac_text_matcher agrees with parse_mac_address") {
+  auto const strict = macad_parser::mac_text_matcher<macad_parser::parse_mac_options_strict>{0xA0B1C2D3E4F5ull};
+  REQUIRE(strict.value() == 0xA0B1C2D3E4F5ull);
+  REQUIRE(strict.matches("A0:B1:C2:D3:E4:F5"));
+  REQUIRE(strict.matches("a0:b1:c2:d3:e4:f5"));
+  REQUIRE(strict.matches("a0:B1:c2:D3:e4:F5 trailing text"));
+  REQUIRE_FALSE(strict.matches("A0:B1:C2:D3:E4:F"));
+  REQUIRE_FALSE(strict.matches("A0-B1-C2-D3-E4-F5"));
+  REQUIRE_FALSE(strict.matches("A0:B1:C2:D3:E4:F6"));
+  // 0x20 をORすると数字やデリミタになる制御文字・記号とは一致しない
+  REQUIRE_FALSE(strict.matches("\x10" "0:B1:C2:D3:E4:F5"));
+  REQUIRE_FALSE(strict.matches("A0\x1A" "B1:C2:D3:E4:F5"));
+  REQUIRE_FALSE(strict.matches("A0:B1:C2:D3:E4:\x06" "5"));
+
+  // デリミタを検証しないオプションではデリミタの位置は比べない
+  auto const loose = macad_parser::mac_text_matcher{0xA0B1C2D3E4F5ull};
+  REQUIRE(loose.matches("A0-B1 C2.D3:E4/F5"));
+  REQUIRE(macad_parser::mac_text_matcher<hyphen_options>{0xA0B1C2D3E4F5ull}.matches("a0-b1-c2-d3-e4-f5"));
+
+  // 16進数として正しい入力では parse_mac_address と同じ判定になる
+  auto const target = macad_parser::mac_text_matcher<hyphen_options>{0x0A1B2C3D4E5Full};
+  for (auto const* const text : {"0A-1B-2C-3D-4E-5F", "0a-1b-2c-3d-4e-5f", "0A-1B-2C-3D-4E-5E", "0A:1B:2C:3D:4E:5F", "FF-FF-FF-FF-FF-FF", "0A-1B-2C-3D-4E-5G"}) {
+    REQUIRE(target.matches(text) == (macad_parser::parse_mac_address<hyphen_options>(text) == target.value()));
+  }
+}
+
+TEST_CASE("lazy_mac parses on first access and caches the result") {
+  auto const text = std::string{"AA:BB:CC:DD:EE:FF"};
+  auto const mac  = macad_parser::lazy_mac<macad_parser::parse_mac_options_strict>{text};
+  auto const key  = macad_parser::mac_text_matcher<macad_parser::parse_mac_options_strict>{0xAABBCCDDEEFFull};
+  auto const miss = macad_parser::mac_text_matcher<macad_parser::parse_mac_options_strict>{0xAABBCCDDEEFEull};
+
+  REQUIRE(mac.text() == text);
+  REQUIRE(mac == key);
+  REQUIRE_FALSE(mac == miss);
+  REQUIRE_FALSE(mac.is_parsed());
+
+  REQUIRE(mac.value() == 0xAABBCCDDEEFFull);
+  REQUIRE(mac.is_parsed());
+  REQUIRE(mac == key);
+  REQUIRE_FALSE(mac == miss);
+  REQUIRE(mac == 0xAABBCCDDEEFFull);
+
+  auto const invalid = macad_parser::lazy_mac<macad_parser::parse_mac_options_strict>{"AA:BB:CC:DD:EE:GG"};
+  REQUIRE_FALSE(invalid == 0xAABBCCDDEEFFull);
+  REQUIRE(invalid.is_parsed());
+  REQUIRE_FALSE(invalid.value());
+  REQUIRE_FALSE(invalid == key);
+
+  REQUIRE_FALSE(macad_parser::lazy_mac<>{}.value());
+}
+
+TEST_CASE("materialize_mac_addresses parses only the survivors") {
+  auto texts = std::vector<std::string>{};
+  for (auto i = std::uint64_t{0}; i < 300; ++i) {
+    texts.push_back(i % 10 == 4 ? "short" : macad_parser::format_mac_address(i));
+  }
+  auto records = std::vector<macad_parser::lazy_mac<>>{};
+  for (auto const& t : texts) {
+    records.emplace_back(t);
+  }
+  REQUIRE(records[1].value() == 1);
+
+  auto survivors = std::vector<std::size_t>{};
+  for (auto i = std::size_t{0}; i < records.size(); i += 2) {
+    survivors.push_back(i);
+  }
+  survivors.push_back(1);
+  survivors.push_back(records.size());
+
+  auto const expected = static_cast<std::size_t>(std::count_if(survivors.begin(), survivors.end(), [&](std::size_t const i) { return i < records.size() and i % 10 != 4; }));
+  REQUIRE(macad_parser::materialize_mac_addresses(records, survivors) == expected);
+  for (auto i = std::size_t{0}; i < records.size(); ++i) {
+    REQUIRE(records[i].is_parsed() == (i % 2 == 0 or i == 1));
+    if (records[i].is_parsed()) {
+      REQUIRE(records[i].value() == macad_parser::parse_mac_address(texts[i]));
+    }
+  }
+}
@@ -0,0 +1,176 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-lines.hpp"
+#include "macad-parser.hpp"
+
+namespace {
+
+// 行頭にMACアドレス、その後ろに長さの違う列を持つテキスト（一部の行はMACアドレスではない）
+auto make_text(std::size_t const lines) -> std::string {
+  auto text = std::string{};
+  for (auto i = std::uint64_t{0}; i < lines; ++i) {
+    if (i % 11 == 5) {
+      text += "# comment";
+    } else if (i % 13 == 6) {
+      text += "";
+    } else {
+      text += macad_parser::format_mac_address(0x020000000000ull + i * 0x10001ull);
+    }
+    text.append(i % 37, ' ');
+    text += ",port" + std::to_string(i) + '\n';
+  }
+  return text;
+}
+
+auto split_lines(std::string_view const text) -> std::vector<std::string_view> {
+  auto lines = std::vector<std::string_view>{};
+  for (auto pos = std::size_t{0}; pos < text.size();) {
+    auto const end = std::min(text.find('\n', pos), text.size());
+    lines.push_back(text.substr(pos, end - pos));
+    pos = end + 1;
+  }
+  return lines;
+}
+
+auto temp_path(std::string_view const name) -> std::string {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+}  // namespace
+
+TEST_CASE("mac_line_index finds every line start") {
+  auto const text     = make_text(3000);
+  auto const index    = macad_parser::mac_line_index::build(text);
+  auto const expected = split_lines(text);
+  REQUIRE(index.size() == expected.size());
+  REQUIRE(index.text_size() == text.size());
+  for (auto n = std::size_t{0}; n < expected.size(); ++n) {
+    REQUIRE(index.offset(n) == static_cast<std::size_t>(expected[n].data() - text.data()));
+    REQUIRE(index.line(text, n) == expected[n]);
+  }
+
+  // 改行で終わらない最後の行、空のテキスト、改行だけの行
+  auto const unterminated = std::string_view{text}.substr(0, text.size() - 1);
+  REQUIRE(macad_parser::mac_line_index::build(unterminated).size() == expected.size());
+  REQUIRE(macad_parser::mac_line_index::build(unterminated).line(unterminated, expected.size() - 1) == expected.back());
+  REQUIRE(macad_parser::mac_line_index::build("").size() == 0);
+  REQUIRE(macad_parser::mac_line_index::build("\n\n").size() == 2);
+  REQUIRE(macad_parser::mac_line_index::build("\n\nx").line("\n\nx", 2) == "x");
+}
+
+TEST_CASE("mac_line_index parses the MAC address at the start of a line") {
+  auto const text  = make_text(3000);
+  auto const index = macad_parser::mac_line_index::build(text);
+  auto const lines = split_lines(text);
+  for (auto n = std::size_t{0}; n < lines.size(); ++n) {
+    REQUIRE(index.parse(text, n) == macad_parser::parse_mac_address(lines[n]));
+  }
+
+  // テキストの末尾で32byte読み取れない行
+  auto const tail  = std::string{"x\nAA:BB:CC:DD:EE:FF"};
+  auto const short_index = macad_parser::mac_line_index::build(tail);
+  REQUIRE(short_index.parse(tail, 1) == 0xAABBCCDDEEFFull);
+  REQUIRE_FALSE(short_index.parse(tail, 0).has_value());
+
+  auto out   = std::vector<std::optional<std::uint64_t>>(lines.size() + 5);
+  auto valid = std::size_t{0};
+  for (auto const line : lines) {
+    valid += macad_parser::parse_mac_address(line).has_value() ? 1 : 0;
+  }
+  REQUIRE(index.parse_lines(text, 0, out) == valid);
+  REQUIRE_FALSE(out.back().has_value());
+}
+
+TEST_CASE("mac_line_index can be parsed from several threads") {
+  auto const text  = make_text(20000);
+  auto const index = macad_parser::mac_line_index::build(text);
+
+  auto expected = std::vector<std::optional<std::uint64_t>>(index.size());
+  index.parse_lines(text, 0, expected);
+
+  constexpr auto threads = std::size_t{4};
+  auto           out     = std::vector<std::optional<std::uint64_t>>(index.size());
+  {
+    auto workers = std::vector<std::jthread>{};
+    auto const per = (index.size() + threads - 1) / threads;
+    for (auto t = std::size_t{0}; t < threads; ++t) {
+      auto const first = std::min(t * per, index.size());
+      auto const count = std::min(per, index.size() - first);
+      workers.emplace_back([&, first, count] { index.parse_lines(text, first, std::span{out}.subspan(first, count)); });
+    }
+  }
+  REQUIRE(out == expected);
+}
+
+TEST_CASE("mac_line_index saves and loads a sidecar file") {
+  auto const text  = make_text(5000);
+  auto const path  = temp_path("macad_parser_test.lix");
+  auto const index = macad_parser::mac_line_index::build(text);
+  REQUIRE(index.save(path));
+
+  auto const loaded = macad_parser::mac_line_index::load(path, text);
+  REQUIRE(loaded.has_value());
+  REQUIRE(loaded->size() == index.size());
+  for (auto n = std::size_t{0}; n < index.size(); ++n) {
+    REQUIRE(loaded->offset(n) == index.offset(n));
+  }
+
+  // テキストが変わった場合は使わない
+  auto changed = text;
+  changed[0]   = 'b';
+  REQUIRE_FALSE(macad_parser::mac_line_index::load(path, changed).has_value());
+  REQUIRE_FALSE(macad_parser::mac_line_index::load(path, text + "x").has_value());
+
+  // 壊れたファイルは使わない
+  {
+    auto* const fp = std::fopen(path.c_str(), "r+b");
+    REQUIRE(fp != nullptr);
+    std::fseek(fp, -3, SEEK_END);
+    std::fputc(0x7F, fp);
+    std::fclose(fp);
+  }
+  REQUIRE_FALSE(macad_parser::mac_line_index::load(path, text).has_value());
+
+  // 使えなければ作り直して保存する
+  REQUIRE(macad_parser::mac_line_index::load_or_build(path, text).size() == index.size());
+  REQUIRE(macad_parser::mac_line_index::load(path, text).has_value());
+
+  std::filesystem::remove(path);
+  REQUIRE_FALSE(macad_parser::mac_line_index::load(path, text).has_value());
+}
+
+TEST_CASE("mac_line_index rejects line starts that are not ascending") {
+  auto const text = std::string_view{"a\nbb\nccc\n"};
+  auto const path = temp_path("macad_parser_test_order.lix");
+
+  // チェックサムは合っているが、行の先頭の順序が入れ替わったファイル
+  auto const write = [&](std::array<std::uint32_t, 3> const low) {
+    namespace detail = macad_parser::detail;
+    auto const header = detail::line_index_header{detail::LINE_INDEX_MAGIC, detail::LINE_INDEX_VERSION, 0, text.size(), detail::sample_text_hash(text), low.size(), 0,
+                                                  detail::checksum(nullptr, 0, detail::checksum(low.data(), sizeof(low)))};
+    auto* const fp = std::fopen(path.c_str(), "wb");
+    REQUIRE(fp != nullptr);
+    std::fwrite(&header, sizeof(header), 1, fp);
+    std::fwrite(low.data(), sizeof(std::uint32_t), low.size(), fp);
+    std::fclose(fp);
+  };
+
+  write({0, 2, 5});
+  REQUIRE(macad_parser::mac_line_index::load(path, text).has_value());
+  write({0, 5, 2});
+  REQUIRE_FALSE(macad_parser::mac_line_index::load(path, text).has_value());
+  write({0, 2, 2});
+  REQUIRE_FALSE(macad_parser::mac_line_index::load(path, text).has_value());
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-padded.hpp"
+
+TEST_CASE("padded_string guarantees aligned storage and tail padding") {
+  auto const text = macad_parser::padded_string{std::string_view{"AA:BB:CC:DD:EE:FF"}};
+
+  REQUIRE(text.size() == 17);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(text.data()) % macad_parser::padded_string::ALIGNMENT == 0);
+  for (auto i = std::size_t{0}; i < macad_parser::MAC_ADDRESS_PADDING; ++i) {
+    REQUIRE(text.data()[text.size() + i] == '\0');
+  }
+
+  auto const copy  = text;
+  auto       tmp   = copy;
+  auto const moved = std::move(tmp);
+  REQUIRE(std::string_view{copy.view()} == "AA:BB:CC:DD:EE:FF");
+  REQUIRE(std::string_view{moved.view()} == "AA:BB:CC:DD:EE:FF");
+  REQUIRE(copy.data() != text.data());
+}
+
+TEST_CASE("parse_mac_address accepts padded input") {
+  auto const text = macad_parser::padded_string{std::string_view{"01:23:45:67:89:AB\nAA:BB:CC:DD:EE:FF"}};
+
+  REQUIRE(macad_parser::parse_mac_address(text) == 0x0123456789ABull);
+
+  // 部分文字列もパディングの保証を引き継ぐ
+  auto const second = text.view().substr(18);
+  REQUIRE(second.size() == 17);
+  REQUIRE(macad_parser::parse_mac_address<macad_parser::parse_mac_options_strict>(second) == 0xAABBCCDDEEFFull);
+  REQUIRE_FALSE(macad_parser::parse_mac_address(text.view().substr(18, 10)).has_value());
+  REQUIRE(text.view().substr(100).empty());
+}
+
+TEST_CASE("padded_string_view keeps the padding within capacity") {
+  auto const buffer = std::string(64, 'A');
+
+  // パディングを確保できない分は長さを切り詰める
+  REQUIRE(macad_parser::padded_string_view{buffer.data(), 40, buffer.size()}.size() == 32);
+  REQUIRE(macad_parser::padded_string_view{buffer.data(), 17, buffer.size()}.size() == 17);
+  REQUIRE(macad_parser::padded_string_view{buffer.data(), 17, 16}.empty());
+}
+
+TEST_CASE("padded_string::load reads a whole file") {
+  auto const path = (std::filesystem::temp_directory_path() / "macad_parser_test_padded.txt").string();
+  {
+    auto* const fp = std::fopen(path.c_str(), "wb");
+    REQUIRE(fp != nullptr);
+    std::fputs("AA:BB:CC:DD:EE:FF\n", fp);
+    std::fclose(fp);
+  }
+
+  auto const loaded = macad_parser::padded_string::load(path);
+  std::filesystem::remove(path);
+  REQUIRE(loaded.has_value());
+  REQUIRE(std::string_view{loaded->view()} == "AA:BB:CC:DD:EE:FF\n");
+  REQUIRE(loaded->data()[loaded->size()] == '\0');
+  REQUIRE(macad_parser::parse_mac_address(*loaded) == 0xAABBCCDDEEFFull);
+
+  REQUIRE_FALSE(macad_parser::padded_string::load(path).has_value());
+}
+
+TEST_CASE("padded_string::read continues from the current position") {
+  auto const path = (std::filesystem::temp_directory_path() / "macad_parser_test_padded_read.txt").string();
+  auto* const fp  = std::fopen(path.c_str(), "w+b");
+  REQUIRE(fp != nullptr);
+  std::fputs("header\nAA:BB:CC:DD:EE:FF\n", fp);
+  std::rewind(fp);
+
+  char line[8] = {};
+  REQUIRE(std::fgets(line, sizeof(line), fp) != nullptr);
+  auto const rest = macad_parser::padded_string::read(fp);
+  std::fclose(fp);
+  std::filesystem::remove(path);
+
+  REQUIRE(rest.has_value());
+  REQUIRE(std::string_view{rest->view()} == "AA:BB:CC:DD:EE:FF\n");
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-pipeline.hpp"
+
+TEST_CASE("spsc ring buffer") {
+  auto ring = macad_parser::spsc_ring<int>{3};
+  REQUIRE(ring.capacity() == 4);
+
+  SECTION("push until full and pop in order") {
+    for (auto i = 0; i < 4; ++i) {
+      REQUIRE(ring.try_push(i));
+    }
+    auto extra = 4;
+    REQUIRE_FALSE(ring.try_push(extra));
+    for (auto i = 0; i < 4; ++i) {
+      REQUIRE(ring.try_pop() == i);
+    }
+    REQUIRE_FALSE(ring.try_pop().has_value());
+  }
+
+  SECTION("drained after close") {
+    auto v = 1;
+    REQUIRE(ring.try_push(v));
+    ring.close();
+    REQUIRE_FALSE(ring.drained());
+    REQUIRE(ring.try_pop() == 1);
+    REQUIRE(ring.drained());
+  }
+
+  SECTION("transfers across threads") {
+    auto sum      = std::uint64_t{0};
+    auto consumer = std::jthread{[&] {
+      while (true) {
+        if (auto v = ring.try_pop()) {
+          sum += static_cast<std::uint64_t>(*v);
+        } else if (ring.drained()) {
+          break;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }};
+    for (auto i = 1; i <= 10000; ++i) {
+      while (not ring.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+    ring.close();
+    consumer.join();
+    REQUIRE(sum == 10000ull * 10001ull / 2);
+  }
+}
+
+TEST_CASE("mac pipeline read -> parse -> aggregate") {
+  auto text     = std::string{};
+  auto expected = std::set<std::uint64_t>{};
+  for (auto i = std::uint64_t{1}; i <= 3000; ++i) {
+    auto const mac = (i * 0x0000010000010001ull) & 0xFFFFFFFFFFFFull;
+    expected.insert(mac);
+    text += "id=" + std::to_string(i) + " mac=" + macad_parser::format_mac_address(mac) + "\n";
+  }
+
+  // 小さいチャンクと小さいリングでチャンク境界とバックプレッシャーを通す
+  auto config          = macad_parser::pipeline_config{};
+  config.chunk_size    = 100;
+  config.ring_capacity = 2;
+
+  auto pos     = std::size_t{0};
+  auto buffers = std::set<char const*>{};
+  auto read    = [&](std::span<char> const buffer) {
+    buffers.insert(buffer.data());
+    auto const n = std::min(buffer.size(), text.size() - pos);
+    std::memcpy(buffer.data(), text.data() + pos, n);
+    pos += n;
+    return n;
+  };
+
+  auto found   = std::set<std::uint64_t>{};
+  auto count   = std::size_t{0};
+  auto metrics = macad_parser::run_mac_pipeline(
+    read,
+    [&](std::span<std::uint64_t const> const macs) {
+      count += macs.size();
+      found.insert(macs.begin(), macs.end());
+    },
+    config);
+
+  REQUIRE(count == expected.size());
+  REQUIRE(found == expected);
+  REQUIRE(metrics.macs == expected.size());
+  REQUIRE(metrics.read.bytes == text.size());
+  REQUIRE(metrics.parse.bytes == text.size());
+  REQUIRE(metrics.parse.items == metrics.aggregate.items);
+  REQUIRE(metrics.parse.utilization() >= 0.0);
+  REQUIRE(metrics.parse.utilization() <= 1.0);
+  // 読み込み先のバッファは使い回される（リングの容量 + 読み込み中 + パース中）
+  REQUIRE(buffers.size() <= config.ring_capacity + 2);
+}
+
+TEST_CASE("mac pipeline without newlines") {
+  // 改行がなく、チャンクの境界がMACアドレスの途中に来る入力
+  auto text     = std::string{};
+  auto expected = std::vector<std::uint64_t>{};
+  for (auto i = std::uint64_t{1}; i <= 2000; ++i) {
+    auto const mac = (i * 0x0000010000010001ull) & 0xFFFFFFFFFFFFull;
+    expected.push_back(mac);
+    text += macad_parser::format_mac_address(mac) + ((i % 3 == 0) ? ", " : " ");
+  }
+
+  for (auto const chunk_size : {std::size_t{7}, std::size_t{100}, std::size_t{1000}, std::size_t{4096}}) {
+    auto config          = macad_parser::pipeline_config{};
+    config.chunk_size    = chunk_size;
+    config.ring_capacity = 2;
+
+    auto pos  = std::size_t{0};
+    auto read = [&](std::span<char> const buffer) {
+      auto const n = std::min(buffer.size(), text.size() - pos);
+      std::memcpy(buffer.data(), text.data() + pos, n);
+      pos += n;
+      return n;
+    };
+
+    auto found   = std::vector<std::uint64_t>{};
+    auto metrics = macad_parser::run_mac_pipeline(
+      read, [&](std::span<std::uint64_t const> const macs) { found.insert(found.end(), macs.begin(), macs.end()); }, config);
+
+    INFO("chunk_size = " << chunk_size);
+    REQUIRE(found == expected);
+    REQUIRE(metrics.macs == expected.size());
+    REQUIRE(metrics.read.bytes == text.size());
+  }
+}
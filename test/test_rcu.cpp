@@ -0,0 +1,116 @@
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-rcu.hpp"
+
+namespace {
+
+// OUI（上位24bit）からベンダ名を引くテーブルの代わり
+struct vendor_table {
+  std::unordered_map<std::uint64_t, std::string> vendors;
+  std::uint64_t                                  version = 0;
+  std::atomic<int>*                              destroyed = nullptr;
+
+  ~vendor_table() {
+    if (destroyed != nullptr) {
+      destroyed->fetch_add(1);
+    }
+  }
+};
+
+auto make_table(std::uint64_t const version, std::atomic<int>* const destroyed) -> std::unique_ptr<vendor_table const> {
+  auto t       = std::make_unique<vendor_table>();
+  t->version   = version;
+  t->destroyed = destroyed;
+  t->vendors.emplace(0xAABBCC, "vendor-" + std::to_string(version));
+  return t;
+}
+
+}  // namespace
+
+TEST_CASE("rcu snapshot publish and reclaim") {
+  auto destroyed = std::atomic<int>{0};
+  auto domain    = macad_parser::rcu_domain{4};
+  auto snapshot  = macad_parser::rcu_snapshot<vendor_table>{domain, make_table(1, &destroyed)};
+  auto reader    = domain.register_reader();
+  REQUIRE(reader.has_value());
+
+  auto const& v1 = snapshot.read();
+  REQUIRE(v1.version == 1);
+
+  SECTION("old version survives until the reader is quiescent") {
+    REQUIRE(snapshot.publish(make_table(2, &destroyed)) == 1);
+    REQUIRE(snapshot.read().version == 2);
+
+    REQUIRE(snapshot.reclaim() == 0);
+    REQUIRE(destroyed == 0);
+    REQUIRE(v1.vendors.at(0xAABBCC) == "vendor-1");
+
+    reader->quiescent();
+    REQUIRE(snapshot.reclaim() == 1);
+    REQUIRE(destroyed == 1);
+    REQUIRE(snapshot.retired() == 0);
+  }
+
+  SECTION("offline readers do not block reclamation") {
+    reader->offline();
+    snapshot.update([&](vendor_table const& current) { return make_table(current.version + 1, &destroyed); });
+    REQUIRE(snapshot.read().version == 2);
+    REQUIRE(snapshot.reclaim() == 1);
+  }
+
+  SECTION("registration is bounded") {
+    auto others = std::vector<macad_parser::rcu_domain::reader>{};
+    for (auto i = 0; i < 3; ++i) {
+      others.push_back(domain.register_reader().value());
+    }
+    REQUIRE_FALSE(domain.register_reader().has_value());
+    others.clear();
+    REQUIRE(domain.register_reader().has_value());
+  }
+}
+
+TEST_CASE("rcu snapshot concurrent readers") {
+  auto destroyed = std::atomic<int>{0};
+  auto domain    = macad_parser::rcu_domain{8};
+  auto snapshot  = macad_parser::rcu_snapshot<vendor_table>{domain, make_table(0, &destroyed)};
+  auto stop      = std::atomic<bool>{false};
+  auto errors    = std::atomic<int>{0};
+
+  {
+    auto readers = std::vector<std::jthread>{};
+    for (auto t = 0; t < 4; ++t) {
+      readers.emplace_back([&] {
+        auto r    = domain.register_reader().value();
+        auto last = std::uint64_t{0};
+        while (not stop.load(std::memory_order_relaxed)) {
+          auto const& table = snapshot.read();
+          // 版は単調に増え、参照中の版は解放されない
+          if (table.version < last or table.vendors.at(0xAABBCC) != "vendor-" + std::to_string(table.version)) {
+            errors.fetch_add(1);
+          }
+          last = table.version;
+          r.quiescent();
+        }
+      });
+    }
+
+    for (auto version = std::uint64_t{1}; version <= 200; ++version) {
+      snapshot.publish(make_table(version, &destroyed));
+      snapshot.reclaim();
+    }
+    stop = true;
+  }
+
+  snapshot.reclaim();
+  REQUIRE(errors == 0);
+  REQUIRE(snapshot.retired() == 0);
+  REQUIRE(destroyed == 200);
+}
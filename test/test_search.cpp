@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-search.hpp"
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+struct hyphen_lower_options {
+  static constexpr char delimiter = '-';
+  static constexpr bool uppercase = false;
+};
+
+auto make_targets(std::size_t const n) -> std::vector<std::uint64_t> {
+  auto targets = std::vector<std::uint64_t>{};
+  for (auto i = std::uint64_t{0}; i < n; ++i) {
+    targets.push_back(test_support::mac_value(i + 1));
+  }
+  return targets;
+}
+
+}  // namespace
+
+TEST_CASE("mac_watchlist has no false negatives or false positives") {
+  auto const targets   = make_targets(10000);
+  auto const watchlist = macad_parser::mac_watchlist{targets};
+  REQUIRE(watchlist.size() == targets.size());
+
+  for (auto const t : targets) {
+    REQUIRE(watchlist.contains(t));
+    REQUIRE(watchlist.contains(t | 0xFFFF000000000000ull));
+  }
+  auto hits = 0;
+  for (auto i = std::uint64_t{0}; i < 100000; ++i) {
+    hits += watchlist.contains(0x020000000000ull + i) ? 1 : 0;
+  }
+  REQUIRE(hits == 0);
+
+  auto const duplicated = std::vector<std::uint64_t>{1, 1, 2};
+  REQUIRE(macad_parser::mac_watchlist{duplicated}.size() == 2);
+  REQUIRE_FALSE(macad_parser::mac_watchlist{std::span<std::uint64_t const>{}}.contains(0));
+}
+
+TEST_CASE("search_mac_watchlist reports matching lines in any case and delimiter") {
+  auto const targets   = std::vector<std::uint64_t>{0xAABBCCDDEEFFull, 0x0123456789ABull};
+  auto const watchlist = macad_parser::mac_watchlist{targets};
+
+  auto const text = std::string{
+    "2024-01-01 ok src=11:22:33:44:55:66\n"
+    "2024-01-01 hit src=aa-bb-cc-dd-ee-ff dst=01:23:45:67:89:AB\n"
+    "no mac here at all, just words and numbers 1234567890 and more words\n"
+    "mixed AA:BB-CC:DD:EE:FF is not a MAC address\n"
+    "upper 01-23-45-67-89-AB\n"
+    "short aa:bb:cc:dd:ee:f\n"
+    "last Aa:bB:cC:dD:eE:fF"};
+
+  auto lines   = std::vector<std::size_t>{};
+  auto matches = std::vector<std::size_t>{};
+  auto macs    = std::vector<std::uint64_t>{};
+  auto const n = macad_parser::search_mac_watchlist(text, watchlist, [&](std::size_t const line, std::size_t const match, std::uint64_t const mac) {
+    lines.push_back(line);
+    matches.push_back(match);
+    macs.push_back(mac);
+  });
+
+  auto const line_of = [&](std::string_view const prefix) { return text.find(prefix); };
+  REQUIRE(n == 3);
+  REQUIRE(lines == std::vector<std::size_t>{line_of("2024-01-01 hit"), line_of("upper"), line_of("last")});
+  REQUIRE(matches == std::vector<std::size_t>{text.find("aa-bb"), text.find("01-23"), text.find("Aa:bB")});
+  REQUIRE(macs == std::vector<std::uint64_t>{0xAABBCCDDEEFFull, 0x0123456789ABull, 0xAABBCCDDEEFFull});
+  REQUIRE(macad_parser::search_mac_watchlist(text, watchlist) == lines);
+}
+
+TEST_CASE("search_mac_watchlist agrees with a line-by-line search") {
+  auto const targets   = make_targets(1000);
+  auto const watchlist = macad_parser::mac_watchlist{targets};
+
+  // 該当する行・該当しないMACアドレスだけの行・MACアドレスのない行を、長さを変えながら混ぜる
+  auto text     = std::string{};
+  auto expected = std::vector<std::size_t>{};
+  for (auto i = std::uint64_t{0}; i < 5000; ++i) {
+    auto const line = text.size();
+    text.append(i % 7, 'x');
+    if (i % 5 == 0) {
+      text += " src=" + macad_parser::format_mac_address<hyphen_lower_options>(0x020000000000ull + i);
+    }
+    if (i % 3 == 0) {
+      text += " dst=" + macad_parser::format_mac_address(targets[i % targets.size()]);
+      expected.push_back(line);
+    }
+    if (i % 6 == 0) {
+      text += " again=" + macad_parser::format_mac_address<hyphen_lower_options>(targets[(i + 1) % targets.size()]);
+    }
+    text += '\n';
+  }
+
+  REQUIRE(macad_parser::search_mac_watchlist(text, watchlist) == expected);
+
+  // 末尾に改行がなく、ゼロ埋めバッファで処理される行
+  text += "tail " + macad_parser::format_mac_address(targets[0]);
+  expected.push_back(text.rfind('\n') + 1);
+  REQUIRE(macad_parser::search_mac_watchlist(text, watchlist) == expected);
+
+  // 行の途中で切れている場合は見つからない
+  REQUIRE(macad_parser::search_mac_watchlist(std::string_view{text}.substr(0, text.size() - 1), watchlist).size() == expected.size() - 1);
+}
@@ -0,0 +1,104 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-padded.hpp"
+#include "macad-parser-stats.hpp"
+#include "macad-parser.hpp"
+
+namespace {
+
+// テストケースごとに別々のカウンタを使う
+template <typename Tag>
+struct counted_strict_options : macad_parser::parse_mac_options_strict {
+  using stats = macad_parser::thread_local_mac_stats<Tag>;
+};
+
+struct kernels_tag;
+struct format_tag;
+struct threads_tag;
+
+}  // namespace
+
+TEST_CASE("stats policy counts results and kernels") {
+  using options = counted_strict_options<kernels_tag>;
+  using stats   = options::stats;
+
+  auto const before = stats::snapshot();
+  auto const padded = macad_parser::padded_string{std::string_view{"AA:BB:CC:DD:EE:FF"}};
+  auto const long_s = std::string{"AA:BB:CC:DD:EE:FF is followed by more than 32 bytes"};
+
+  REQUIRE(macad_parser::parse_mac_address<options>("AA:BB:CC:DD:EE:FF") == 0xAABBCCDDEEFFull);
+  REQUIRE(macad_parser::parse_mac_address<options>(long_s) == 0xAABBCCDDEEFFull);
+  REQUIRE(macad_parser::parse_mac_address<options>(padded) == 0xAABBCCDDEEFFull);
+  REQUIRE_FALSE(macad_parser::parse_mac_address<options>("AA:BB"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address<options>("AA-BB-CC-DD-EE-FF"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address<options>("AA:BB:CC:DD:EE:FG"));
+
+  auto const diff = stats::snapshot() - before;
+  REQUIRE(diff.count(macad_parser::parse_status::success) == 3);
+  REQUIRE(diff.count(macad_parser::parse_status::too_short) == 1);
+  REQUIRE(diff.count(macad_parser::parse_status::invalid_delimiter) == 1);
+  REQUIRE(diff.count(macad_parser::parse_status::invalid_hex) == 1);
+  REQUIRE(diff.failures() == 3);
+
+  REQUIRE(diff.count(macad_parser::parse_kernel::none) == 1);
+  REQUIRE(diff.count(macad_parser::parse_kernel::direct) == 2);
+  REQUIRE(diff.count(macad_parser::parse_kernel::copied) == 3);
+  REQUIRE(diff.parsed[static_cast<std::size_t>(macad_parser::parse_status::success)][static_cast<std::size_t>(macad_parser::parse_kernel::copied)] == 1);
+  REQUIRE(diff.formatted == 0);
+}
+
+TEST_CASE("stats policy counts formatting including batch APIs") {
+  using options = counted_strict_options<format_tag>;
+  using stats   = options::stats;
+
+  auto const before = stats::snapshot();
+  auto const values = std::array<std::uint64_t, 3>{0x1, 0x2, 0x3};
+  auto       buffer = std::array<char, 3 * macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+
+  REQUIRE(macad_parser::format_mac_address<options>(0xAABBCCDDEEFFull) == "AA:BB:CC:DD:EE:FF");
+  macad_parser::format_mac_addresses_to_buffer<options>(values, buffer);
+
+  auto const views   = std::array<std::string_view, 2>{"01:02:03:04:05:06", "bad"};
+  auto       results = std::array<std::optional<std::uint64_t>, 2>{};
+  REQUIRE(macad_parser::parse_mac_addresses<options>(views, results) == 1);
+
+  auto const diff = stats::snapshot() - before;
+  REQUIRE(diff.formatted == 4);
+  REQUIRE(diff.count(macad_parser::parse_status::success) == 1);
+  REQUIRE(diff.count(macad_parser::parse_status::too_short) == 1);
+}
+
+TEST_CASE("stats policy aggregates counters of all threads") {
+  using options = counted_strict_options<threads_tag>;
+  using stats   = options::stats;
+
+  constexpr auto THREADS    = 8;
+  constexpr auto ITERATIONS = 10000;
+
+  auto const before = stats::snapshot();
+  for (auto round = 0; round < 2; ++round) {
+    auto workers = std::vector<std::jthread>{};
+    for (auto t = 0; t < THREADS; ++t) {
+      workers.emplace_back([] {
+        for (auto i = 0; i < ITERATIONS; ++i) {
+          static_cast<void>(macad_parser::parse_mac_address<options>(i % 2 == 0 ? "AA:BB:CC:DD:EE:FF" : "AA:BB:CC:DD:EE:GG"));
+        }
+      });
+    }
+    // 実行中に読み出しても合計は単調に増える
+    auto const during = stats::snapshot();
+    REQUIRE(during.count(macad_parser::parse_status::success) >= before.count(macad_parser::parse_status::success));
+  }
+
+  // 2回目のスレッドは1回目のスレッドが返却したスロットを再利用するが、回数は失われない
+  auto const diff = stats::snapshot() - before;
+  REQUIRE(diff.count(macad_parser::parse_status::success) == 2 * THREADS * ITERATIONS / 2);
+  REQUIRE(diff.count(macad_parser::parse_status::invalid_hex) == 2 * THREADS * ITERATIONS / 2);
+}
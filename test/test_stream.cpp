@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-stream.hpp"
+
+namespace {
+
+auto make_log(std::size_t const lines) -> std::string {
+  auto text = std::string{};
+  for (auto i = std::uint64_t{1}; i <= lines; ++i) {
+    text += "t=" + std::to_string(i * 7) + " mac=" + macad_parser::format_mac_address(i * 0x000100010001ull) + ((i % 5 == 0) ? "\n" : " ");
+  }
+  return text;
+}
+
+auto scan_all(std::string const& text) -> std::vector<std::uint64_t> {
+  auto values = std::vector<std::uint64_t>{};
+  macad_parser::scan_mac_addresses(text, [&](std::size_t, std::uint64_t const v) { values.push_back(v); });
+  return values;
+}
+
+}  // namespace
+
+TEST_CASE("generator yields values lazily") {
+  auto       produced = 0;
+  auto const gen      = [&]() -> macad_parser::generator<int> {
+    for (auto i = 0; i < 3; ++i) {
+      ++produced;
+      co_yield i;
+    }
+  };
+
+  auto g  = gen();
+  REQUIRE(produced == 0);
+  auto it = g.begin();
+  REQUIRE(produced == 1);
+  REQUIRE(*it == 0);
+  ++it;
+  REQUIRE(*it == 1);
+  ++it;
+  REQUIRE(*it == 2);
+  ++it;
+  REQUIRE(it == g.end());
+}
+
+TEST_CASE("read mac addresses from a byte source") {
+  auto const text     = make_log(500);
+  auto const expected = scan_all(text);
+  REQUIRE(expected.size() == 500);
+
+  // チャンク境界がMACアドレスの途中に来るよう、様々なチャンクサイズで試す
+  for (auto const chunk : {std::size_t{1}, std::size_t{7}, std::size_t{16}, std::size_t{17}, std::size_t{33}, std::size_t{4096}}) {
+    auto pos  = std::size_t{0};
+    auto read = [&](std::span<char> const buffer) {
+      auto const n = std::min(buffer.size(), text.size() - pos);
+      std::memcpy(buffer.data(), text.data() + pos, n);
+      pos += n;
+      return n;
+    };
+    auto values = std::vector<std::uint64_t>{};
+    for (auto const mac : macad_parser::read_mac_addresses(read, chunk)) {
+      values.push_back(mac);
+    }
+    REQUIRE(values == expected);
+  }
+}
+
+TEST_CASE("read mac addresses from an istream") {
+  auto in     = std::istringstream{"a=AA:BB:CC:DD:EE:FF b=01:23:45:67:89:AB:CD"};
+  auto values = std::vector<std::uint64_t>{};
+  for (auto const mac : macad_parser::read_mac_addresses(in, 8)) {
+    values.push_back(mac);
+  }
+  REQUIRE(values == std::vector<std::uint64_t>{0xAABBCCDDEEFFull, 0x0123456789ABull});
+}
+
+TEST_CASE("mac_stream_scanner matches scanning the concatenated text") {
+  // 隣り合う・重なり合うMACアドレスや、途中で途切れた候補を含むテキスト
+  auto text = make_log(200);
+  text += "AA:BB:CC:DD:EE:FF:11:22:33:44:55:66 01:23:45:67:89:A 01:23:45:67:89:AB01:23:45:67:89:AB";
+  auto expected = std::vector<std::pair<std::size_t, std::uint64_t>>{};
+  macad_parser::scan_mac_addresses(text, [&](std::size_t const offset, std::uint64_t const v) { expected.emplace_back(offset, v); });
+
+  auto seed = std::uint64_t{7};
+  for (auto round = 0; round < 200; ++round) {
+    auto scanner = macad_parser::mac_stream_scanner<>{};
+    auto found   = std::vector<std::pair<std::size_t, std::uint64_t>>{};
+    auto pos     = std::size_t{0};
+    while (pos < text.size()) {
+      seed           = seed * 6364136223846793005ull + 1442695040888963407ull;
+      auto const max = (round % 2 == 0) ? 40 : 400;
+      auto const n   = std::min<std::size_t>((seed >> 33) % max, text.size() - pos);
+      scanner.feed(std::span<char const>{text.data() + pos, n}, [&](std::size_t const offset, std::uint64_t const v) { found.emplace_back(offset, v); });
+      REQUIRE(scanner.pending() <= macad_parser::MAC_ADDRESS_STRING_LENGTH - 1);
+      pos += n;
+    }
+    REQUIRE(scanner.consumed() == text.size());
+    REQUIRE(found == expected);
+  }
+}
+
+TEST_CASE("mac_stream_scanner accepts scatter-gather segments") {
+  auto const text     = std::string_view{"src=AA:BB:CC:DD:EE:FF dst=01-23-45-67-89-ab via 01:23:45:67:89:AB"};
+  auto const segments = std::array<std::span<char const>, 4>{
+    std::span<char const>{text.data(), 10},
+    std::span<char const>{text.data() + 10, 0},
+    std::span<char const>{text.data() + 10, 40},
+    std::span<char const>{text.data() + 50, text.size() - 50},
+  };
+
+  auto scanner = macad_parser::mac_stream_scanner<>{};
+  auto offsets = std::vector<std::size_t>{};
+  REQUIRE(scanner.feed(segments, [&](std::size_t const offset, std::uint64_t) { offsets.push_back(offset); }) == 2);
+  REQUIRE(offsets == std::vector<std::size_t>{text.find("AA:BB"), text.find("01:23")});
+
+  scanner.reset();
+  REQUIRE(scanner.pending() == 0);
+  REQUIRE(scanner.consumed() == 0);
+}
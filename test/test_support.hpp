@@ -0,0 +1,118 @@
+#ifndef MACAD_PARSER_TEST_SUPPORT_HPP
+#define MACAD_PARSER_TEST_SUPPORT_HPP
+
+// テスト・Benchmark で共通に使うヘルパー
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "macad-parser-padded.hpp"
+#include "macad-parser.hpp"
+
+namespace test_support {
+
+/**
+ * @brief 改行区切りで並べたときの1行の長さ
+ */
+inline constexpr auto LINE_LENGTH = macad_parser::MAC_ADDRESS_STRING_LENGTH + 1;
+
+/**
+ * @brief i番目のテスト用MACアドレス（連番を乗算で48bit全体に散らした値）
+ */
+[[nodiscard]]
+constexpr auto mac_value(std::uint64_t const i) noexcept -> std::uint64_t {
+  return (i * 0x9E3779B97F4A7C15ull) >> 16;
+}
+
+/**
+ * @brief `mac_value(0)` から `mac_value(n - 1)` までの並び
+ */
+[[nodiscard]]
+inline auto mac_values(std::size_t const n) -> std::vector<std::uint64_t> {
+  auto values = std::vector<std::uint64_t>(n);
+  for (auto i = std::size_t{0}; i < n; ++i) {
+    values[i] = mac_value(i);
+  }
+  return values;
+}
+
+/**
+ * @brief `text` を先頭から `mac_value(i)` の改行区切りの行で埋める（1行に満たない末尾はそのまま）
+ */
+inline void fill_mac_lines(std::span<char> const text) noexcept {
+  auto const lines = text.size() / LINE_LENGTH;
+  for (auto i = std::size_t{0}; i < lines; ++i) {
+    auto* const line = text.data() + i * LINE_LENGTH;
+    macad_parser::format_mac_address_to_buffer(mac_value(i), std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{line, macad_parser::MAC_ADDRESS_STRING_LENGTH});
+    line[macad_parser::MAC_ADDRESS_STRING_LENGTH] = '\n';
+  }
+}
+
+/**
+ * @brief `fill_mac_lines` で埋めた `size` バイトのパディング付きの入力
+ */
+[[nodiscard]]
+inline auto make_mac_lines(std::size_t const size) -> macad_parser::padded_string {
+  auto text = macad_parser::padded_string{size};
+  fill_mac_lines(std::span<char>{text.data(), size});
+  return text;
+}
+
+/**
+ * @brief "4096" / "64K" / "256m" / "4G" のようなサイズを読む
+ *
+ * 接尾辞（K/M/G）は大文字・小文字のどちらでもよい
+ *
+ * @return 数値で始まらない・知らない接尾辞や余分な文字が続く・桁あふれする場合は `std::nullopt`
+ */
+inline auto parse_size(std::string_view const s) -> std::optional<std::size_t> {
+  auto       value = std::size_t{0};
+  auto const res   = std::from_chars(s.data(), s.data() + s.size(), value);
+  if (res.ec != std::errc{}) {
+    return std::nullopt;
+  }
+  auto const rest  = std::string_view{res.ptr, s.data() + s.size()};
+  auto       shift = 0;
+  if (rest == "K" or rest == "k") {
+    shift = 10;
+  } else if (rest == "M" or rest == "m") {
+    shift = 20;
+  } else if (rest == "G" or rest == "g") {
+    shift = 30;
+  } else if (not rest.empty()) {
+    return std::nullopt;
+  }
+  if (value > (std::numeric_limits<std::size_t>::max() >> shift)) {
+    return std::nullopt;
+  }
+  return value << shift;
+}
+
+/**
+ * @brief 環境変数からサイズを読む（`parse_size` の形式）
+ *
+ * @return 未設定の場合は `fallback`。読めない場合は標準エラー出力に知らせてから `fallback`
+ */
+inline auto env_size(char const* const name, std::size_t const fallback) -> std::size_t {
+  auto const* const env = std::getenv(name);
+  if (env == nullptr) {
+    return fallback;
+  }
+  if (auto const size = parse_size(env)) {
+    return *size;
+  }
+  std::fprintf(stderr, "%s=%s is not a size (e.g. 4096, 64K, 256m, 4G), using %zu\n", name, env, fallback);
+  return fallback;
+}
+
+}  // namespace test_support
+
+#endif /* MACAD_PARSER_TEST_SUPPORT_HPP */
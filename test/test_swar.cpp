@@ -0,0 +1,26 @@
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-padded.hpp"
+#include "macad-parser-swar.hpp"
+#include "macad-parser.hpp"
+#include "test_support.hpp"
+
+TEST_CASE("SWAR kernels round-trip like the SIMD kernels") {
+  constexpr auto lines = std::size_t{1024};
+  auto const     input = test_support::make_mac_lines(lines * test_support::LINE_LENGTH);
+  for (auto i = std::size_t{0}; i < lines; ++i) {
+    auto const line     = input.view().substr(i * test_support::LINE_LENGTH, macad_parser::MAC_ADDRESS_STRING_LENGTH);
+    auto const expected = macad_parser::parse_mac_address(line);
+    REQUIRE(expected == test_support::mac_value(i));
+    REQUIRE(macad_parser::swar::parse_mac_address(line) == expected);
+
+    auto text = std::array<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+    REQUIRE(macad_parser::swar::format_mac_address_to_buffer(*expected, text) == macad_parser::MAC_ADDRESS_STRING_LENGTH);
+    REQUIRE(std::string_view{text.data(), text.size()} == std::string_view{line});
+  }
+  REQUIRE(macad_parser::swar::parse_mac_address("aa:bb:cc:dd:ee:ff") == 0xAABBCCDDEEFFull);
+}
@@ -0,0 +1,131 @@
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-table.hpp"
+
+struct port_time {
+  std::uint16_t port;
+  std::uint32_t time;
+};
+
+TEST_CASE("concurrent mac table basic operations") {
+  auto table = macad_parser::concurrent_mac_table<port_time>{100};
+  REQUIRE(table.capacity() == 128);
+
+  SECTION("insert and update") {
+    REQUIRE_FALSE(table.find(0xAABBCCDDEEFFull).has_value());
+    REQUIRE(table.upsert(0xAABBCCDDEEFFull, port_time{1, 100}));
+    REQUIRE(table.find(0xAABBCCDDEEFFull)->port == 1);
+
+    REQUIRE(table.upsert(0xAABBCCDDEEFFull, port_time{2, 200}));
+    auto const v = table.find(0xAABBCCDDEEFFull);
+    REQUIRE(v.has_value());
+    REQUIRE(v->port == 2);
+    REQUIRE(v->time == 200);
+    REQUIRE(table.size() == 1);
+  }
+
+  SECTION("upper 16 bits are ignored") {
+    REQUIRE(table.upsert(0xFFFF000000000001ull, port_time{3, 0}));
+    REQUIRE(table.find(0x000000000001ull)->port == 3);
+    REQUIRE(table.size() == 1);
+  }
+
+  SECTION("zero is a valid key") {
+    REQUIRE(table.upsert(0, port_time{4, 0}));
+    REQUIRE(table.find(0)->port == 4);
+  }
+}
+
+TEST_CASE("concurrent mac table reports full") {
+  auto table = macad_parser::concurrent_mac_table<>{4};
+  for (auto i = std::uint64_t{0}; i < 4; ++i) {
+    REQUIRE(table.upsert(i, i));
+  }
+  REQUIRE_FALSE(table.upsert(4, 4));
+  REQUIRE(table.upsert(2, 20));
+  REQUIRE(table.find(2) == 20u);
+  REQUIRE_FALSE(table.find(4).has_value());
+}
+
+TEST_CASE("concurrent mac table multi-threaded upserts") {
+  constexpr auto threads = 4u;
+  constexpr auto per     = std::uint64_t{5000};
+
+  auto table = macad_parser::concurrent_mac_table<>{threads * per * 2};
+  {
+    auto workers = std::vector<std::jthread>{};
+    for (auto t = 0u; t < threads; ++t) {
+      workers.emplace_back([&table, t] {
+        // 全スレッドが同じキー集合を書き、さらに自スレッド固有のキーも書く
+        for (auto i = std::uint64_t{0}; i < per; ++i) {
+          table.upsert(0x001122000000ull + i, i);
+          table.upsert((std::uint64_t{t + 1} << 40) + i, i * 2);
+        }
+      });
+    }
+  }
+
+  REQUIRE(table.size() == per * (threads + 1));
+  for (auto i = std::uint64_t{0}; i < per; i += 97) {
+    REQUIRE(table.find(0x001122000000ull + i) == i);
+    for (auto t = 0u; t < threads; ++t) {
+      REQUIRE(table.find((std::uint64_t{t + 1} << 40) + i) == i * 2);
+    }
+  }
+}
+
+TEST_CASE("parse_and_hash_mac_addresses matches parse and mix") {
+  auto texts = std::vector<std::string>{};
+  for (auto i = std::uint64_t{0}; i < 23; ++i) {
+    texts.push_back(i == 5 ? "not a mac" : macad_parser::format_mac_address(i * 0x0123456789ABull));
+  }
+  auto const views  = std::vector<std::string_view>(texts.begin(), texts.end());
+  auto       out    = std::vector<std::optional<std::uint64_t>>(views.size());
+  auto       hashes = std::vector<std::uint64_t>(views.size());
+
+  REQUIRE(macad_parser::parse_and_hash_mac_addresses(views, out, hashes) == views.size() - 1);
+  for (auto i = std::size_t{0}; i < views.size(); ++i) {
+    REQUIRE(out[i] == macad_parser::parse_mac_address(views[i]));
+    if (out[i]) {
+      REQUIRE(hashes[i] == macad_parser::detail::mix_mac_address(*out[i]));
+    }
+  }
+}
+
+TEST_CASE("concurrent mac table upserts parsed strings in batches") {
+  constexpr auto count = std::uint64_t{1000};
+
+  auto texts  = std::vector<std::string>{};
+  auto values = std::vector<std::uint64_t>{};
+  for (auto i = std::uint64_t{0}; i < count; ++i) {
+    texts.push_back(i % 100 == 7 ? "AA:BB:CC:DD:EE:GG" : macad_parser::format_mac_address(0x020000000000ull + i));
+    values.push_back(i);
+  }
+  auto const views = std::vector<std::string_view>(texts.begin(), texts.end());
+
+  auto table = macad_parser::concurrent_mac_table<>{count * 2};
+  REQUIRE(table.upsert_mac_addresses<macad_parser::parse_mac_options_strict>(views, values) == count - count / 100);
+  REQUIRE(table.size() == count - count / 100);
+  for (auto i = std::uint64_t{0}; i < count; ++i) {
+    REQUIRE(table.find(0x020000000000ull + i) == (i % 100 == 7 ? std::nullopt : std::optional{i}));
+  }
+
+  SECTION("values shorter than strings") {
+    auto small = macad_parser::concurrent_mac_table<>{16};
+    REQUIRE(small.upsert_mac_addresses(std::span{views}.first(3), std::span{values}.first(2)) == 2);
+    REQUIRE(small.size() == 2);
+  }
+
+  SECTION("full table skips the rest") {
+    auto small = macad_parser::concurrent_mac_table<>{4};
+    REQUIRE(small.upsert_mac_addresses(views, values) == 4);
+  }
+}
@@ -0,0 +1,72 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-unicode.hpp"
+#include "macad-parser.hpp"
+
+namespace {
+
+struct hyphen_lower_options {
+  static constexpr bool validate_delimiters = true;
+  static constexpr bool validate_hex        = true;
+  static constexpr char delimiter           = '-';
+  static constexpr bool uppercase           = false;
+};
+
+template <typename String>
+auto widen(std::string_view const s) -> String {
+  return String(s.begin(), s.end());
+}
+
+}  // namespace
+
+TEST_CASE("UTF-16 and UTF-32 strings parse like narrow strings") {
+  REQUIRE(macad_parser::parse_mac_address(u"AA:BB:CC:DD:EE:FF") == 0xAABBCCDDEEFFull);
+  REQUIRE(macad_parser::parse_mac_address(U"aa:bb:cc:dd:ee:ff") == 0xAABBCCDDEEFFull);
+  REQUIRE(macad_parser::parse_mac_address<hyphen_lower_options>(u"01-23-45-67-89-ab and more") == 0x0123456789ABull);
+  REQUIRE_FALSE(macad_parser::parse_mac_address(u"AA:BB:CC:DD:EE:F"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address(U""));
+
+  for (auto const* const text : {"AA:BB:CC:DD:EE:FF", "01:23:45:67:89:ab", "AA:BB:CC:DD:EE:GG", "AA-BB-CC-DD-EE-FF", "0a:1B:2c:3D:4e:5F", "zz:zz:zz:zz:zz:zz"}) {
+    auto const expected = macad_parser::parse_mac_address<macad_parser::parse_mac_options_strict>(text);
+    REQUIRE(macad_parser::parse_mac_address<macad_parser::parse_mac_options_strict>(widen<std::u16string>(text)) == expected);
+    REQUIRE(macad_parser::parse_mac_address<macad_parser::parse_mac_options_strict>(widen<std::u32string>(text)) == expected);
+  }
+}
+
+TEST_CASE("non-ASCII code units are rejected by validation") {
+  using strict = macad_parser::parse_mac_options_strict;
+
+  // 下位8bitだけを見ると 'A'、':'、'1' になるコード単位
+  REQUIRE_FALSE(macad_parser::parse_mac_address<strict>(u"ŁA:BB:CC:DD:EE:FF"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address<strict>(u"AAĺBB:CC:DD:EE:FF"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address<strict>(u"AA:BB:CC:DD:EE:Fı"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address<strict>(u"AA:BB:CC:DD:EE:FÆ"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address<strict>(U"\U00010041A:BB:CC:DD:EE:FF"));
+  REQUIRE_FALSE(macad_parser::parse_mac_address<strict>(U"AA:BB:CC:DD:EE:F\U00010031"));
+
+  auto invalid = std::u32string{U"AA:BB:CC:DD:EE:FF"};
+  invalid[3]   = static_cast<char32_t>(0x80000041u);
+  REQUIRE_FALSE(macad_parser::parse_mac_address<strict>(invalid));
+}
+
+TEST_CASE("UTF-16 and UTF-32 formatting") {
+  REQUIRE(macad_parser::format_mac_address_u16(0xAABBCCDDEEFFull) == u"AA:BB:CC:DD:EE:FF");
+  REQUIRE(macad_parser::format_mac_address_u32(0x0123456789ABull) == U"01:23:45:67:89:AB");
+  REQUIRE(macad_parser::format_mac_address_u16<hyphen_lower_options>(0xA0B1C2D3E4F5ull) == u"a0-b1-c2-d3-e4-f5");
+
+  auto u16 = std::array<char16_t, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+  auto u32 = std::array<char32_t, macad_parser::MAC_ADDRESS_STRING_LENGTH>{};
+  for (auto const v : {0x000000000000ull, 0xFFFFFFFFFFFFull, 0x123456789ABCull}) {
+    REQUIRE(macad_parser::format_mac_address_to_buffer(v, u16) == macad_parser::MAC_ADDRESS_STRING_LENGTH);
+    REQUIRE(macad_parser::format_mac_address_to_buffer(v, u32) == macad_parser::MAC_ADDRESS_STRING_LENGTH);
+    REQUIRE(std::u16string_view{u16.data(), u16.size()} == widen<std::u16string>(macad_parser::format_mac_address(v)));
+    REQUIRE(std::u32string_view{u32.data(), u32.size()} == widen<std::u32string>(macad_parser::format_mac_address(v)));
+    REQUIRE(macad_parser::parse_mac_address(std::u16string_view{u16.data(), u16.size()}) == v);
+    REQUIRE(macad_parser::parse_mac_address(std::u32string_view{u32.data(), u32.size()}) == v);
+  }
+}
@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_all.hpp"
+
+#include "macad-parser-views.hpp"
+
+struct opt_views_lower {
+  static constexpr bool uppercase = false;
+};
+
+namespace {
+
+auto make_values(std::size_t const n) -> std::vector<std::uint64_t> {
+  auto values = std::vector<std::uint64_t>(n);
+  for (auto i = std::size_t{0}; i < n; ++i) {
+    values[i] = (i * 0x0000010203040506ull) & 0xFFFFFFFFFFFFull;
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST_CASE("views::parse matches transform(parse_mac_address)") {
+  auto const values = make_values(100);
+  auto       texts  = std::vector<std::string>{};
+  for (auto const v : values) {
+    texts.push_back(macad_parser::format_mac_address(v));
+  }
+  texts[10] = "not a mac";
+
+  SECTION("non-contiguous string_view elements") {
+    auto parsed = std::vector<std::optional<std::uint64_t>>{};
+    for (auto const v : texts | macad_parser::views::parse) {
+      parsed.push_back(v);
+    }
+    REQUIRE(parsed.size() == texts.size());
+    for (auto i = std::size_t{0}; i < texts.size(); ++i) {
+      REQUIRE(parsed[i] == macad_parser::parse_mac_address(texts[i]));
+    }
+  }
+
+  SECTION("contiguous string_views") {
+    auto const views  = std::vector<std::string_view>(texts.begin(), texts.end());
+    auto       parsed = std::vector<std::optional<std::uint64_t>>{};
+    for (auto const v : macad_parser::views::parse_with<macad_parser::parse_mac_options_strict>(views)) {
+      parsed.push_back(v);
+    }
+    REQUIRE(parsed.size() == views.size());
+    REQUIRE_FALSE(parsed[10].has_value());
+    REQUIRE(parsed[99] == values[99]);
+  }
+
+  SECTION("composes with std::views") {
+    auto count = std::size_t{0};
+    for (auto const v : texts | std::views::take(50) | macad_parser::views::parse | std::views::filter([](auto const& o) { return o.has_value(); })) {
+      REQUIRE(v.has_value());
+      ++count;
+    }
+    REQUIRE(count == 49);
+  }
+
+  SECTION("elements returned by value") {
+    // 変換結果の一時オブジェクトを参照せず、ブロック内にコピーしてからパースする
+    auto parsed = std::vector<std::optional<std::uint64_t>>{};
+    for (auto const v : std::views::iota(std::size_t{0}, texts.size()) | std::views::transform([&](std::size_t const i) { return std::string{texts[i]}; }) |
+                          macad_parser::views::parse) {
+      parsed.push_back(v);
+    }
+    REQUIRE(parsed.size() == texts.size());
+    for (auto i = std::size_t{0}; i < texts.size(); ++i) {
+      REQUIRE(parsed[i] == macad_parser::parse_mac_address(texts[i]));
+    }
+  }
+
+  SECTION("single-pass input range") {
+    // std::views::istream は同じ文字列を使い回すため、要素ごとにコピーしてからパースする
+    auto joined = std::string{};
+    for (auto const& t : texts) {
+      joined += (t == "not a mac") ? "not-a-mac" : t;
+      joined += '\n';
+    }
+    auto in     = std::istringstream{joined};
+    auto parsed = std::vector<std::optional<std::uint64_t>>{};
+    for (auto const v : std::views::istream<std::string>(in) | macad_parser::views::parse) {
+      parsed.push_back(v);
+    }
+    REQUIRE(parsed.size() == texts.size());
+    REQUIRE_FALSE(parsed[10].has_value());
+    for (auto i = std::size_t{0}; i < texts.size(); ++i) {
+      if (i != 10) {
+        REQUIRE(parsed[i] == values[i]);
+      }
+    }
+  }
+
+  SECTION("sized") {
+    REQUIRE((texts | macad_parser::views::parse).size() == texts.size());
+  }
+}
+
+TEST_CASE("views::format matches format_mac_address") {
+  auto const values = make_values(77);
+
+  SECTION("contiguous input") {
+    auto i = std::size_t{0};
+    for (auto const s : values | macad_parser::views::format_with<opt_views_lower>) {
+      REQUIRE(s == macad_parser::format_mac_address<opt_views_lower>(values[i]));
+      ++i;
+    }
+    REQUIRE(i == values.size());
+  }
+
+  SECTION("non-contiguous input") {
+    auto const list = std::list<std::uint64_t>(values.begin(), values.end());
+    auto       out  = std::vector<std::string>{};
+    for (auto const s : macad_parser::views::format(list)) {
+      out.emplace_back(s);
+    }
+    REQUIRE(out.size() == values.size());
+    REQUIRE(out[76] == macad_parser::format_mac_address(values[76]));
+  }
+
+  SECTION("empty input") {
+    auto const empty = std::vector<std::uint64_t>{};
+    auto       view  = empty | macad_parser::views::format;
+    REQUIRE(view.begin() == view.end());
+  }
+}
@@ -0,0 +1,309 @@
+// macad-bench-compare: ベンチマーク結果（test/benchmark_recorder.cpp が書き出すJSON）をベースラインと比較する
+//
+// 使い方: macad-bench-compare [options] <baseline.json> <current.json>
+//   平均値の信頼区間が重ならず、かつ差がしきい値を超えたものを回帰（または改善）と判定する
+//   回帰が1つでもあれば終了コード1、入力エラーやマシンの不一致は終了コード2
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct benchmark_record {
+  double mean_ns  = 0.0;
+  double lower_ns = 0.0;
+  double upper_ns = 0.0;
+};
+
+struct result_file {
+  std::string                                           fingerprint_id;
+  std::string                                           cpu;
+  std::vector<std::pair<std::string, benchmark_record>> order;
+  std::map<std::string, benchmark_record, std::less<>>  benchmarks;
+};
+
+// benchmark_recorder が書き出す形式だけを読む最小限のJSONパーサ
+class json_reader {
+public:
+  explicit json_reader(std::string_view const text) : text_{text} {}
+
+  auto parse() -> std::optional<result_file> {
+    auto file = result_file{};
+    auto ok   = parse_object([&](std::string const& key) {
+      if (key == "fingerprint") {
+        return parse_object([&](std::string const& k) {
+          if (k == "id") {
+            return parse_string(file.fingerprint_id);
+          }
+          if (k == "cpu") {
+            return parse_string(file.cpu);
+          }
+          return skip_value();
+        });
+      }
+      if (key == "benchmarks") {
+        return parse_array([&] {
+          auto test_case = std::string{};
+          auto name      = std::string{};
+          auto record    = benchmark_record{};
+          auto const ok  = parse_object([&](std::string const& k) {
+            if (k == "test_case") {
+              return parse_string(test_case);
+            }
+            if (k == "name") {
+              return parse_string(name);
+            }
+            if (k == "mean_ns") {
+              return parse_number(record.mean_ns);
+            }
+            if (k == "lower_ns") {
+              return parse_number(record.lower_ns);
+            }
+            if (k == "upper_ns") {
+              return parse_number(record.upper_ns);
+            }
+            return skip_value();
+          });
+          if (ok) {
+            auto key = test_case + " / " + name;
+            file.benchmarks.emplace(key, record);
+            file.order.emplace_back(std::move(key), record);
+          }
+          return ok;
+        });
+      }
+      return skip_value();
+    });
+    return ok ? std::optional{std::move(file)} : std::nullopt;
+  }
+
+private:
+  void skip_ws() {
+    while (pos_ < text_.size() and (text_[pos_] == ' ' or text_[pos_] == '\n' or text_[pos_] == '\r' or text_[pos_] == '\t')) {
+      ++pos_;
+    }
+  }
+
+  auto consume(char const c) -> bool {
+    skip_ws();
+    if (pos_ < text_.size() and text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  template <typename F>
+  auto parse_object(F&& on_member) -> bool {
+    if (not consume('{')) {
+      return false;
+    }
+    if (consume('}')) {
+      return true;
+    }
+    do {
+      auto key = std::string{};
+      if (not parse_string(key) or not consume(':') or not on_member(key)) {
+        return false;
+      }
+    } while (consume(','));
+    return consume('}');
+  }
+
+  template <typename F>
+  auto parse_array(F&& on_element) -> bool {
+    if (not consume('[')) {
+      return false;
+    }
+    if (consume(']')) {
+      return true;
+    }
+    do {
+      if (not on_element()) {
+        return false;
+      }
+    } while (consume(','));
+    return consume(']');
+  }
+
+  auto parse_string(std::string& out) -> bool {
+    if (not consume('"')) {
+      return false;
+    }
+    out.clear();
+    while (pos_ < text_.size()) {
+      auto const c = text_[pos_++];
+      if (c == '"') {
+        return true;
+      }
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) {
+        return false;
+      }
+      switch (auto const e = text_[pos_++]) {
+      case 'n':
+        out += '\n';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u': {
+        auto code = 0u;
+        if (pos_ + 4 > text_.size() or std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, code, 16).ec != std::errc{}) {
+          return false;
+        }
+        out += static_cast<char>(code);
+        pos_ += 4;
+        break;
+      }
+      default:
+        out += e;
+      }
+    }
+    return false;
+  }
+
+  auto parse_number(double& out) -> bool {
+    skip_ws();
+    auto const end = text_.find_first_of(",}] \n", pos_);
+    auto const s   = std::string{text_.substr(pos_, end - pos_)};
+    try {
+      out = std::stod(s);
+    } catch (...) {
+      return false;
+    }
+    pos_ = end;
+    return true;
+  }
+
+  auto skip_value() -> bool {
+    skip_ws();
+    if (pos_ >= text_.size()) {
+      return false;
+    }
+    switch (text_[pos_]) {
+    case '"': {
+      auto ignored = std::string{};
+      return parse_string(ignored);
+    }
+    case '{':
+      return parse_object([&](std::string const&) { return skip_value(); });
+    case '[':
+      return parse_array([&] { return skip_value(); });
+    default:
+      pos_ = text_.find_first_of(",}]", pos_);
+      return pos_ != std::string_view::npos;
+    }
+  }
+
+  std::string_view text_;
+  std::size_t      pos_ = 0;
+};
+
+auto load(char const* const path) -> std::optional<result_file> {
+  auto in = std::ifstream{path, std::ios::binary};
+  if (not in) {
+    std::perror(path);
+    return std::nullopt;
+  }
+  auto ss = std::ostringstream{};
+  ss << in.rdbuf();
+  auto const text = ss.str();
+  auto       file = json_reader{text}.parse();
+  if (not file) {
+    std::fprintf(stderr, "%s: malformed benchmark results\n", path);
+  }
+  return file;
+}
+
+void print_usage() {
+  std::fputs("usage: macad-bench-compare [options] <baseline.json> <current.json>\n"
+             "\n"
+             "options:\n"
+             "  -t, --threshold P   minimum relative change in percent to report (default 5)\n"
+             "  -a, --any-machine   compare even if the machine fingerprints differ\n",
+             stderr);
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  auto threshold   = 5.0;
+  auto any_machine = false;
+  auto paths       = std::vector<char const*>{};
+  for (auto i = 1; i < argc; ++i) {
+    auto const arg = std::string_view{argv[i]};
+    if ((arg == "-t" or arg == "--threshold") and i + 1 < argc) {
+      auto const value = std::string_view{argv[++i]};
+      if (std::from_chars(value.data(), value.data() + value.size(), threshold).ec != std::errc{} or threshold < 0.0) {
+        print_usage();
+        return 2;
+      }
+    } else if (arg == "-a" or arg == "--any-machine") {
+      any_machine = true;
+    } else if (not arg.starts_with('-')) {
+      paths.push_back(argv[i]);
+    } else {
+      print_usage();
+      return 2;
+    }
+  }
+  if (paths.size() != 2) {
+    print_usage();
+    return 2;
+  }
+
+  auto const baseline = load(paths[0]);
+  auto const current  = load(paths[1]);
+  if (not baseline or not current) {
+    return 2;
+  }
+  if (baseline->fingerprint_id != current->fingerprint_id) {
+    std::fprintf(stderr, "macad-bench-compare: machine fingerprint differs (baseline %s \"%s\", current %s \"%s\")\n", baseline->fingerprint_id.c_str(), baseline->cpu.c_str(),
+                 current->fingerprint_id.c_str(), current->cpu.c_str());
+    if (not any_machine) {
+      return 2;
+    }
+  }
+
+  auto regressions  = 0;
+  auto improvements = 0;
+  std::printf("%-72s %12s %12s %8s  %s\n", "benchmark", "baseline ns", "current ns", "change", "verdict");
+  for (auto const& [name, cur] : current->order) {
+    auto const it = baseline->benchmarks.find(name);
+    if (it == baseline->benchmarks.end()) {
+      std::printf("%-72s %12s %12.3f %8s  new\n", name.c_str(), "-", cur.mean_ns, "-");
+      continue;
+    }
+    auto const& base   = it->second;
+    auto const  change = (base.mean_ns > 0.0) ? (cur.mean_ns / base.mean_ns - 1.0) * 100.0 : 0.0;
+
+    // 平均値の信頼区間が重ならない場合だけを有意な差とみなす
+    auto const slower  = cur.lower_ns > base.upper_ns and change > threshold;
+    auto const faster  = cur.upper_ns < base.lower_ns and -change > threshold;
+    auto const verdict = slower ? "REGRESSION" : faster ? "improved" : "~";
+    regressions += slower ? 1 : 0;
+    improvements += faster ? 1 : 0;
+    std::printf("%-72s %12.3f %12.3f %+7.1f%%  %s\n", name.c_str(), base.mean_ns, cur.mean_ns, change, verdict);
+  }
+  for (auto const& [name, base] : baseline->order) {
+    if (not current->benchmarks.contains(name)) {
+      std::printf("%-72s %12.3f %12s %8s  missing\n", name.c_str(), base.mean_ns, "-", "-");
+    }
+  }
+
+  std::printf("\n%d regression(s), %d improvement(s) (threshold %.1f%%)\n", regressions, improvements, threshold);
+  return regressions > 0 ? 1 : 0;
+}
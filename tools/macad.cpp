@@ -0,0 +1,514 @@
+// macad: MACアドレス列を高速に抽出・正規化・整数変換するコマンドラインツール
+//
+// 使い方: macad <mode> [options] [file...]
+//   mode: extract | normalize | to-int | from-int | index
+//   ファイルを指定しない場合（または "-" の場合）は標準入力を読む
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MACAD_HAS_MMAP 1
+#endif
+
+#include "macad-parser-index.hpp"
+#include "macad-parser-padded.hpp"
+#include "macad-parser.hpp"
+
+namespace {
+
+enum class mode { extract, normalize, to_int, from_int, index };
+
+struct cli_options {
+  mode                     run_mode        = mode::extract;
+  char                     input_delimiter = ':';
+  char                     delimiter       = ':';
+  bool                     uppercase       = true;
+  bool                     hex             = false;
+  bool                     quiet           = false;
+  unsigned                 threads         = 1;
+  std::string              output;
+  std::vector<std::string> files;
+};
+
+// 1回の処理単位（行境界で区切る）
+constexpr std::size_t BLOCK_SIZE = std::size_t{64} << 20;
+
+struct counters {
+  std::size_t records = 0;
+  std::size_t invalid = 0;
+};
+
+template <char InDelim, char OutDelim, bool Upper>
+struct config {
+  // 入力側: デリミタと16進数文字を厳密に検証する
+  struct in_options {
+    static constexpr bool validate_delimiters = true;
+    static constexpr bool validate_hex        = true;
+    static constexpr char delimiter           = InDelim;
+  };
+
+  // スキャナで確定済みの入力を正規化するときは再検証しない
+  struct in_trusted_options {
+    static constexpr char delimiter = InDelim;
+  };
+
+  struct out_options {
+    static constexpr char delimiter = OutDelim;
+    static constexpr bool uppercase = Upper;
+  };
+};
+
+// 行を順に取り出す（末尾の '\r' は取り除く）
+template <typename F>
+void for_each_line(macad_parser::padded_string_view const block, F&& f) {
+  auto const text = std::string_view{block};
+  auto       pos  = std::size_t{0};
+  while (pos < text.size()) {
+    auto const nl  = text.find('\n', pos);
+    auto const end = (nl == std::string_view::npos) ? text.size() : nl;
+    auto       len = end - pos;
+    if (len > 0 and text[pos + len - 1] == '\r') {
+      --len;
+    }
+    f(block.substr(pos, len));
+    pos = end + 1;
+  }
+}
+
+// extract で見つかった値を何件ずつまとめて文字列に変換するか
+constexpr std::size_t EXTRACT_BATCH = 256;
+
+template <typename Config>
+void process_extract(std::string_view const block, std::string& out, counters& c) {
+  constexpr auto LENGTH = macad_parser::MAC_ADDRESS_STRING_LENGTH;
+
+  auto values = std::array<std::uint64_t, EXTRACT_BATCH>{};
+  auto text   = std::array<char, EXTRACT_BATCH * LENGTH>{};
+  auto n      = std::size_t{0};
+  // 溜めた値を format_mac_addresses_to_buffer でまとめて変換し、1行ずつ書き出す
+  auto const flush = [&] {
+    macad_parser::format_mac_addresses_to_buffer<typename Config::out_options>(std::span<std::uint64_t const>{values.data(), n}, text);
+    auto const at = out.size();
+    out.resize(at + n * (LENGTH + 1));
+    auto* dst = out.data() + at;
+    for (auto i = std::size_t{0}; i < n; ++i, dst += LENGTH + 1) {
+      std::memcpy(dst, text.data() + i * LENGTH, LENGTH);
+      dst[LENGTH] = '\n';
+    }
+    n = 0;
+  };
+
+  out.reserve(out.size() + block.size() / 2);
+  c.records += macad_parser::scan_mac_addresses<typename Config::in_options>(block, [&](std::size_t, std::uint64_t const value) {
+    values[n++] = value;
+    if (n == EXTRACT_BATCH) {
+      flush();
+    }
+  });
+  flush();
+}
+
+template <typename Config>
+void process_normalize(std::string_view const block, std::string& out, counters& c) {
+  auto const base = out.size();
+  out.append(block);
+  auto* const dst = out.data() + base;
+  c.records += macad_parser::scan_mac_addresses<typename Config::in_options>(block, [&](std::size_t const offset, std::uint64_t) {
+    auto const text = std::string_view{dst + offset, macad_parser::MAC_ADDRESS_STRING_LENGTH};
+    static_cast<void>(macad_parser::canonicalize_mac_address_to_buffer<typename Config::in_trusted_options, typename Config::out_options>(
+      text, std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{dst + offset, macad_parser::MAC_ADDRESS_STRING_LENGTH}));
+  });
+}
+
+template <typename Config>
+void process_to_int(macad_parser::padded_string_view const block, std::string& out, counters& c, bool const hex) {
+  out.reserve(out.size() + block.size());
+  for_each_line(block, [&](macad_parser::padded_string_view const line) {
+    ++c.records;
+    // 入力は末尾にパディングがあるので、コピーなしで unsafe 版のカーネルが使われる
+    auto const value = macad_parser::parse_mac_address<typename Config::in_options>(line);
+    if (value) {
+      char buf[24];
+      auto ptr = buf;
+      if (hex) {
+        *ptr++ = '0';
+        *ptr++ = 'x';
+      }
+      ptr = std::to_chars(ptr, buf + sizeof(buf), value.value(), hex ? 16 : 10).ptr;
+      out.append(buf, ptr);
+    } else {
+      ++c.invalid;
+    }
+    out.push_back('\n');
+  });
+}
+
+template <typename Config>
+void process_from_int(macad_parser::padded_string_view const block, std::string& out, counters& c, bool const hex) {
+  out.reserve(out.size() + block.size() * 2);
+  for_each_line(block, [&](std::string_view line) {
+    ++c.records;
+    auto base = hex ? 16 : 10;
+    if (line.starts_with("0x") or line.starts_with("0X")) {
+      line.remove_prefix(2);
+      base = 16;
+    }
+    auto       value       = std::uint64_t{0};
+    auto const [ptr, ec]   = std::from_chars(line.data(), line.data() + line.size(), value, base);
+    auto const well_formed = ec == std::errc{} and ptr == line.data() + line.size() and value <= 0xFFFFFFFFFFFFull;
+    if (well_formed) {
+      auto const at = out.size();
+      out.resize(at + macad_parser::MAC_ADDRESS_STRING_LENGTH);
+      macad_parser::format_mac_address_to_buffer<typename Config::out_options>(value, std::span<char, macad_parser::MAC_ADDRESS_STRING_LENGTH>{out.data() + at, macad_parser::MAC_ADDRESS_STRING_LENGTH});
+    } else {
+      ++c.invalid;
+    }
+    out.push_back('\n');
+  });
+}
+
+// 見つかったMACアドレスを整数のままバイト列として書き出す（インデックスファイルの材料）
+template <typename Config>
+void process_index(std::string_view const block, std::string& out, counters& c) {
+  c.records += macad_parser::scan_mac_addresses<typename Config::in_options>(block, [&](std::size_t, std::uint64_t const value) {
+    out.append(reinterpret_cast<char const*>(&value), sizeof(value));
+  });
+}
+
+template <typename Config>
+void process(cli_options const& opts, macad_parser::padded_string_view const block, std::string& out, counters& c) {
+  switch (opts.run_mode) {
+  case mode::extract:
+    process_extract<Config>(block, out, c);
+    break;
+  case mode::normalize:
+    process_normalize<Config>(block, out, c);
+    break;
+  case mode::to_int:
+    process_to_int<Config>(block, out, c, opts.hex);
+    break;
+  case mode::from_int:
+    process_from_int<Config>(block, out, c, opts.hex);
+    break;
+  case mode::index:
+    process_index<Config>(block, out, c);
+    break;
+  }
+}
+
+// 実行時のオプションをコンパイル時のOptionsに振り分ける
+template <typename F>
+auto dispatch(cli_options const& opts, F&& f) -> bool {
+  auto const with_out = [&]<char InDelim>() {
+    auto const with_case = [&]<char OutDelim>() {
+      if (opts.uppercase) {
+        f.template operator()<config<InDelim, OutDelim, true>>();
+      } else {
+        f.template operator()<config<InDelim, OutDelim, false>>();
+      }
+    };
+    switch (opts.delimiter) {
+    case ':':
+      with_case.template operator()<':'>();
+      return true;
+    case '-':
+      with_case.template operator()<'-'>();
+      return true;
+    default:
+      return false;
+    }
+  };
+  switch (opts.input_delimiter) {
+  case ':':
+    return with_out.template operator()<':'>();
+  case '-':
+    return with_out.template operator()<'-'>();
+  default:
+    return false;
+  }
+}
+
+class block_processor {
+public:
+  explicit block_processor(cli_options const& opts) : opts_{opts}, outputs_(opts.threads), counts_(opts.threads) {}
+
+  // 行境界で終わるブロックをスレッド数に分割して処理し、入力順に書き出す
+  void run(macad_parser::padded_string_view const block) {
+    auto const n     = std::max(1u, opts_.threads);
+    auto const text  = std::string_view{block};
+    auto       parts = std::vector<macad_parser::padded_string_view>{};
+    auto       pos   = std::size_t{0};
+    for (auto i = 1u; i <= n and pos < block.size(); ++i) {
+      auto end = (i == n) ? block.size() : std::max(pos, block.size() * i / n);
+      if (end < block.size()) {
+        auto const nl = text.find('\n', end);
+        end           = (nl == std::string_view::npos) ? block.size() : nl + 1;
+      }
+      parts.push_back(block.substr(pos, end - pos));
+      pos = end;
+    }
+
+    auto const work = [&](std::size_t const i) {
+      outputs_[i].clear();
+      dispatch(opts_, [&]<typename Config>() { process<Config>(opts_, parts[i], outputs_[i], counts_[i]); });
+    };
+    if (parts.size() == 1) {
+      work(0);
+    } else {
+      auto workers = std::vector<std::jthread>{};
+      for (auto i = std::size_t{1}; i < parts.size(); ++i) {
+        workers.emplace_back(work, i);
+      }
+      work(0);
+    }
+
+    for (auto i = std::size_t{0}; i < parts.size(); ++i) {
+      if (opts_.run_mode == mode::index) {
+        auto const at = collected_.size();
+        collected_.resize(at + outputs_[i].size() / sizeof(std::uint64_t));
+        std::memcpy(collected_.data() + at, outputs_[i].data(), outputs_[i].size());
+        continue;
+      }
+      std::fwrite(outputs_[i].data(), 1, outputs_[i].size(), stdout);
+      bytes_out_ += outputs_[i].size();
+    }
+    bytes_in_ += block.size();
+  }
+
+  [[nodiscard]] auto bytes_in() const noexcept -> std::size_t { return bytes_in_; }
+  [[nodiscard]] auto bytes_out() const noexcept -> std::size_t { return bytes_out_; }
+  // 集めた値を取り出す（インデックスの書き出しでそのまま整列に使うため、コピーせずにムーブする）
+  [[nodiscard]] auto take_collected() noexcept -> std::vector<std::uint64_t> { return std::move(collected_); }
+
+  [[nodiscard]] auto total() const noexcept -> counters {
+    auto sum = counters{};
+    for (auto const& c : counts_) {
+      sum.records += c.records;
+      sum.invalid += c.invalid;
+    }
+    return sum;
+  }
+
+private:
+  cli_options const&         opts_;
+  std::vector<std::string>   outputs_;
+  std::vector<counters>      counts_;
+  std::vector<std::uint64_t> collected_;  // index モードで集めた値（入力順）
+  std::size_t                bytes_in_  = 0;
+  std::size_t                bytes_out_ = 0;
+};
+
+// 行境界で区切りながら FILE* から読み込む
+auto process_stream(std::FILE* fp, block_processor& proc) -> bool {
+  auto buf   = macad_parser::padded_string{BLOCK_SIZE};
+  auto carry = std::size_t{0};
+  while (true) {
+    auto const n = std::fread(buf.data() + carry, 1, buf.size() - carry, fp);
+    if (n == 0) {
+      break;
+    }
+    auto const filled = carry + n;
+    auto const last   = std::string_view{buf.data(), filled}.rfind('\n');
+    if (last == std::string_view::npos) {
+      // 1行がブロックより長い場合はブロックを広げる
+      carry = filled;
+      if (carry == buf.size()) {
+        auto larger = macad_parser::padded_string{buf.size() * 2};
+        std::memcpy(larger.data(), buf.data(), carry);
+        buf = std::move(larger);
+      }
+      continue;
+    }
+    proc.run(buf.view().substr(0, last + 1));
+    carry = filled - (last + 1);
+    std::memmove(buf.data(), buf.data() + last + 1, carry);
+  }
+  if (carry > 0) {
+    proc.run(buf.view().substr(0, carry));
+  }
+  return std::ferror(fp) == 0;
+}
+
+auto process_file(std::string const& path, block_processor& proc) -> bool {
+  if (path == "-") {
+    return process_stream(stdin, proc);
+  }
+#ifdef MACAD_HAS_MMAP
+  auto const fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::perror(path.c_str());
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and st.st_size > 0) {
+    // ファイルの後ろに無名のゼロページを続けて予約し、その先頭にファイルを重ねてマップすることで、
+    // コピーせずに末尾のパディングを確保する
+    auto const size     = static_cast<std::size_t>(st.st_size);
+    auto const page     = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    auto const reserved = (size + macad_parser::MAC_ADDRESS_PADDING + page - 1) / page * page;
+    auto*      region   = ::mmap(nullptr, reserved, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    auto*      data     = (region == MAP_FAILED) ? MAP_FAILED : ::mmap(region, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (data != MAP_FAILED) {
+      ::madvise(data, size, MADV_SEQUENTIAL);
+      auto const text = macad_parser::padded_string_view{static_cast<char const*>(data), size, reserved};
+      auto       pos  = std::size_t{0};
+      while (pos < text.size()) {
+        auto end = std::min(text.size(), pos + BLOCK_SIZE);
+        if (end < text.size()) {
+          auto const nl = std::string_view{text}.rfind('\n', end - 1);
+          end           = (nl == std::string_view::npos or nl < pos) ? text.size() : nl + 1;
+        }
+        proc.run(text.substr(pos, end - pos));
+        pos = end;
+      }
+      ::munmap(region, reserved);
+      ::close(fd);
+      return true;
+    }
+    if (region != MAP_FAILED) {
+      ::munmap(region, reserved);
+    }
+  }
+  ::close(fd);
+#endif
+  auto* const fp = std::fopen(path.c_str(), "rb");
+  if (fp == nullptr) {
+    std::perror(path.c_str());
+    return false;
+  }
+  auto const ok = process_stream(fp, proc);
+  std::fclose(fp);
+  return ok;
+}
+
+void print_usage() {
+  std::fputs("usage: macad <extract|normalize|to-int|from-int|index> [options] [file...]\n"
+             "\n"
+             "modes:\n"
+             "  extract     print every MAC address found in the input, one per line\n"
+             "  normalize   rewrite MAC addresses in place (case / delimiter), keep other text\n"
+             "  to-int      convert one MAC address per line to an integer\n"
+             "  from-int    convert one integer per line to a MAC address\n"
+             "  index       write every MAC address found in the input to a sorted index file (-o)\n"
+             "\n"
+             "options:\n"
+             "  -i, --input-delimiter C   delimiter of input MAC addresses (':' or '-', default ':')\n"
+             "  -d, --delimiter C         delimiter of output MAC addresses (':' or '-', default ':')\n"
+             "  -l, --lower               lowercase hex digits\n"
+             "  -u, --upper               uppercase hex digits (default)\n"
+             "  -x, --hex                 to-int: print 0x-prefixed hex / from-int: read hex\n"
+             "  -t, --threads N           number of worker threads (default 1)\n"
+             "  -o, --output PATH         index: index file to write\n"
+             "  -q, --quiet               do not print throughput stats to stderr\n",
+             stderr);
+}
+
+auto parse_args(int const argc, char** const argv) -> std::optional<cli_options> {
+  if (argc < 2) {
+    return std::nullopt;
+  }
+  auto       opts = cli_options{};
+  auto const name = std::string_view{argv[1]};
+  if (name == "extract") {
+    opts.run_mode = mode::extract;
+  } else if (name == "normalize") {
+    opts.run_mode = mode::normalize;
+  } else if (name == "to-int") {
+    opts.run_mode = mode::to_int;
+  } else if (name == "from-int") {
+    opts.run_mode = mode::from_int;
+  } else if (name == "index") {
+    opts.run_mode = mode::index;
+  } else {
+    return std::nullopt;
+  }
+
+  for (auto i = 2; i < argc; ++i) {
+    auto const arg       = std::string_view{argv[i]};
+    auto const has_value = i + 1 < argc;
+    if ((arg == "-i" or arg == "--input-delimiter") and has_value) {
+      opts.input_delimiter = argv[++i][0];
+    } else if ((arg == "-d" or arg == "--delimiter") and has_value) {
+      opts.delimiter = argv[++i][0];
+    } else if (arg == "-l" or arg == "--lower") {
+      opts.uppercase = false;
+    } else if (arg == "-u" or arg == "--upper") {
+      opts.uppercase = true;
+    } else if (arg == "-x" or arg == "--hex") {
+      opts.hex = true;
+    } else if ((arg == "-o" or arg == "--output") and has_value) {
+      opts.output = argv[++i];
+    } else if (arg == "-q" or arg == "--quiet") {
+      opts.quiet = true;
+    } else if ((arg == "-t" or arg == "--threads") and has_value) {
+      auto const value = std::string_view{argv[++i]};
+      if (std::from_chars(value.data(), value.data() + value.size(), opts.threads).ec != std::errc{} or opts.threads == 0) {
+        return std::nullopt;
+      }
+    } else if (arg == "-" or not arg.starts_with('-')) {
+      opts.files.emplace_back(arg);
+    } else {
+      return std::nullopt;
+    }
+  }
+  if (opts.run_mode == mode::index and opts.output.empty()) {
+    return std::nullopt;
+  }
+  if (opts.files.empty()) {
+    opts.files.emplace_back("-");
+  }
+  return opts;
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  auto const opts = parse_args(argc, argv);
+  if (not opts) {
+    print_usage();
+    return 2;
+  }
+  if (not dispatch(*opts, []<typename>() {})) {
+    std::fputs("macad: delimiter must be ':' or '-'\n", stderr);
+    return 2;
+  }
+
+  auto       proc  = block_processor{*opts};
+  auto const start = std::chrono::steady_clock::now();
+  auto       ok    = true;
+  for (auto const& file : opts->files) {
+    ok = process_file(file, proc) and ok;
+  }
+  std::fflush(stdout);
+  // 読めなかった入力がある場合は、欠けたインデックスで既存のファイルを置き換えない
+  if (opts->run_mode == mode::index and ok and not macad_parser::write_mac_index(opts->output, proc.take_collected())) {
+    std::fprintf(stderr, "macad: could not write %s\n", opts->output.c_str());
+    ok = false;
+  }
+  auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (not opts->quiet) {
+    auto const total = proc.total();
+    auto const mib   = static_cast<double>(proc.bytes_in()) / (1024.0 * 1024.0);
+    std::fprintf(stderr, "macad: %zu bytes in, %zu bytes out, %zu records (%zu invalid), %.3f s, %.1f MiB/s, %u thread(s)\n", proc.bytes_in(), proc.bytes_out(), total.records, total.invalid,
+                 elapsed, elapsed > 0.0 ? mib / elapsed : 0.0, opts->threads);
+  }
+  return ok ? 0 : 1;
+}